@@ -0,0 +1,100 @@
+/*
+Description:
+	Compares writing frequency and histogram reports the original way (one
+	ostream insertion chain, a temporary bar string and endl per row) with
+	ReportWriter's single reusable buffer.
+Build:
+	g++ -std=c++17 -O2 ReportWriterBench.cpp ../Project4/ReportWriter.cpp -o ReportWriterBench
+Usage:
+	ReportWriterBench [items] [output file]
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../Project4/ReportWriter.h"
+
+using namespace std;
+
+struct Row
+{
+	string item;
+	size_t count;
+};
+
+/*
+Description:
+	rows shaped like the produce report, counts spread up to maxCount
+*/
+vector<Row> GenerateRows(size_t itemCount, size_t maxCount)
+{
+	vector<Row> rows;
+	rows.reserve(itemCount);
+	unsigned seed = 2024;
+	for (size_t i = 0; i < itemCount; i++) {
+		seed = seed * 1103515245 + 12345;
+		rows.push_back(Row{ "Item" + to_string(i), 1 + (seed >> 8) % maxCount });
+	}
+	return rows;
+}
+
+template<typename Report>
+double Seconds(Report report)
+{
+	auto start = chrono::steady_clock::now();
+	report();
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void PrintResult(const string& label, double seconds, size_t rows, const string& path)
+{
+	ifstream written(path, ios::binary | ios::ate);
+	double megabytes = static_cast<double>(written.tellg()) / (1024.0 * 1024.0);
+	cout << label << ": " << seconds * 1000.0 << " ms, " << rows / seconds << " rows/s, "
+		<< megabytes << " MB written" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t itemCount = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200000;
+	string path = argc > 2 ? argv[2] : "report_bench.txt";
+	vector<Row> rows = GenerateRows(itemCount, 50);
+	size_t maxCount = 0;
+	for (const Row& row : rows) {
+		maxCount = max(maxCount, row.count);
+	}
+
+	double streamSeconds = Seconds([&]() {
+		ofstream out(path);
+		for (const Row& row : rows) {
+			out << row.item << " :  " << row.count << endl;
+		}
+		for (const Row& row : rows) {
+			out << row.item << " :  " << string(row.count, '*') << endl;
+		}
+	});
+	PrintResult("ostream + endl", streamSeconds, rows.size() * 2, path);
+
+	double writerSeconds = Seconds([&]() {
+		ReportWriter out(stdout);
+		out.Open(path);
+		for (const Row& row : rows) {
+			out.CountRow(row.item, row.count);
+		}
+		for (const Row& row : rows) {
+			out.HistogramRow(row.item, row.count, maxCount);
+		}
+		out.Close();
+	});
+	PrintResult("ReportWriter  ", writerSeconds, rows.size() * 2, path);
+
+	cout << "Speedup: " << streamSeconds / writerSeconds << "x" << endl;
+	remove(path.c_str());
+	return 0;
+}
@@ -0,0 +1,570 @@
+#include "FrequencyEngine.h"
+#include "../../Common/MappedFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+using namespace std;
+
+// inputs smaller than this per thread are counted sequentially
+const size_t minimumChunkBytes = 1 << 20;
+
+// bytes kept from before the follow offset to recognise a rewritten file
+const size_t checkpointBytes = 64;
+
+/*
+Description:
+	counts of one chunk, keyed by views into the mapped file
+*/
+struct ChunkCounts
+{
+	vector<string_view> items;	// first-seen order within the chunk
+	vector<size_t> counts;
+	unordered_map<string_view, size_t> index;
+};
+
+/*
+Description:
+	Snapshot file layout, all integers in native byte order:
+		SnapshotHeader
+		uint64_t counts[itemCount]
+		uint64_t offsets[itemCount + 1]		item i is strings[offsets[i], offsets[i + 1])
+		char strings[stringBytes]
+*/
+struct SnapshotHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t headerBytes;
+	uint64_t sourceSize;
+	int64_t sourceModified;
+	uint64_t consumedBytes;		// follow offset when the snapshot was written
+	uint64_t tailItem;			// item on the unterminated last line, or noTail
+	uint64_t itemCount;
+	uint64_t stringBytes;
+};
+
+const char snapshotMagic[8] = { 'F', 'R', 'E', 'Q', 'S', 'N', 'A', 'P' };
+const uint32_t snapshotVersion = 1;
+const uint64_t noTail = ~uint64_t(0);
+
+/*
+Description:
+	trims leading and trailing whitespace, matching Python's str.strip()
+*/
+static string_view Trim(string_view line)
+{
+	const char* whitespace = " \t\r\n\v\f";
+	size_t first = line.find_first_not_of(whitespace);
+	if (first == string_view::npos) {
+		return string_view();
+	}
+	size_t last = line.find_last_not_of(whitespace);
+	return line.substr(first, last - first + 1);
+}
+
+bool FrequencyEngine::Load(const string& filePath)
+{
+	MappedFile sourceFile;
+	if (!sourceFile.Open(filePath)) {
+		return false;
+	}
+
+	Reset();
+	if (sketchError > 0.0) {
+		sketch = make_unique<SpaceSaving>(SpaceSaving::CapacityForError(sketchError));
+	}
+
+	sourcePath = filePath;
+	sourceIdentity = sourceFile.Identity();
+	sourceModified = sourceFile.Modified();
+	Consume(sourceFile.View(), 0, 0);
+
+	loaded = true;
+	return true;
+}
+
+void FrequencyEngine::Reset()
+{
+	items.clear();
+	counts.clear();
+	index.clear();
+	ownedItems.clear();
+	snapshot.Close();
+	sketch.reset();
+	tailItem.clear();
+	tailCounted = false;
+	loaded = false;
+}
+
+bool FrequencyEngine::SaveSnapshot(const string& snapshotPath) const
+{
+	if (!loaded || sketch) {
+		return false;
+	}
+
+	SnapshotHeader header = {};
+	memcpy(header.magic, snapshotMagic, sizeof(header.magic));
+	header.version = snapshotVersion;
+	header.headerBytes = sizeof(SnapshotHeader);
+	header.sourceSize = scannedBytes;
+	header.sourceModified = sourceModified;
+	header.consumedBytes = consumedBytes;
+	header.tailItem = noTail;
+	if (tailCounted) {
+		header.tailItem = index.find(tailItem)->second;
+	}
+	header.itemCount = items.size();
+
+	vector<uint64_t> offsets;
+	offsets.reserve(items.size() + 1);
+	offsets.push_back(0);
+	for (string_view item : items) {
+		offsets.push_back(offsets.back() + item.size());
+	}
+	header.stringBytes = offsets.back();
+
+	// write beside the target and rename so a reader never maps a half written file
+	string partialPath = snapshotPath + ".tmp";
+	{
+		ofstream output(partialPath, ios::binary | ios::trunc);
+		if (!output.is_open()) {
+			return false;
+		}
+		vector<uint64_t> wideCounts(counts.begin(), counts.end());
+		output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		output.write(reinterpret_cast<const char*>(wideCounts.data()), wideCounts.size() * sizeof(uint64_t));
+		output.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+		for (string_view item : items) {
+			output.write(item.data(), item.size());
+		}
+		if (!output.good()) {
+			output.close();
+			remove(partialPath.c_str());
+			return false;
+		}
+	}
+
+	remove(snapshotPath.c_str());
+	return rename(partialPath.c_str(), snapshotPath.c_str()) == 0;
+}
+
+bool FrequencyEngine::LoadSnapshot(const string& snapshotPath, const string& filePath)
+{
+	if (sketchError > 0.0) {
+		return false;
+	}
+
+	MappedFile sourceFile;
+	MappedFile snapshotFile;
+	if (!sourceFile.Open(filePath) || !snapshotFile.Open(snapshotPath)) {
+		return false;
+	}
+
+	SnapshotHeader header;
+	string_view image = snapshotFile.View();
+	if (image.size() < sizeof(header)) {
+		return false;
+	}
+	memcpy(&header, image.data(), sizeof(header));
+
+	bool current = memcmp(header.magic, snapshotMagic, sizeof(header.magic)) == 0
+		&& header.version == snapshotVersion
+		&& header.headerBytes == sizeof(SnapshotHeader)
+		&& header.sourceSize == sourceFile.Size()
+		&& header.sourceModified == sourceFile.Modified()
+		&& header.consumedBytes <= header.sourceSize;
+	if (!current) {
+		return false;
+	}
+
+	uint64_t tableBytes = (header.itemCount * 2 + 1) * sizeof(uint64_t);
+	if (header.itemCount > image.size() / sizeof(uint64_t)
+		|| image.size() - sizeof(header) < tableBytes
+		|| image.size() - sizeof(header) - tableBytes != header.stringBytes) {
+		return false;
+	}
+
+	Reset();
+	const char* countData = image.data() + sizeof(header);
+	const char* offsetData = countData + header.itemCount * sizeof(uint64_t);
+	const char* strings = offsetData + (header.itemCount + 1) * sizeof(uint64_t);
+
+	items.reserve(header.itemCount);
+	counts.reserve(header.itemCount);
+	index.reserve(header.itemCount);
+	uint64_t begin = 0;
+	memcpy(&begin, offsetData, sizeof(uint64_t));
+	for (uint64_t i = 0; i < header.itemCount; i++) {
+		uint64_t count = 0;
+		uint64_t end = 0;
+		memcpy(&count, countData + i * sizeof(uint64_t), sizeof(uint64_t));
+		memcpy(&end, offsetData + (i + 1) * sizeof(uint64_t), sizeof(uint64_t));
+		if (end < begin || end > header.stringBytes) {
+			Reset();
+			return false;
+		}
+
+		// item names are used in place from the mapping
+		items.emplace_back(strings + begin, static_cast<size_t>(end - begin));
+		counts.push_back(static_cast<size_t>(count));
+		index.emplace(items.back(), static_cast<size_t>(i));
+		begin = end;
+	}
+
+	// follow state resumes exactly where the snapshot's count stopped
+	sourcePath = filePath;
+	sourceIdentity = sourceFile.Identity();
+	sourceModified = sourceFile.Modified();
+	scannedBytes = static_cast<size_t>(header.sourceSize);
+	consumedBytes = static_cast<size_t>(header.consumedBytes);
+	size_t keep = min(consumedBytes, checkpointBytes);
+	checkpoint.assign(sourceFile.View().substr(consumedBytes - keep, keep));
+	tailCounted = header.tailItem < header.itemCount;
+	if (tailCounted) {
+		tailItem.assign(items[header.tailItem].data(), items[header.tailItem].size());
+	}
+
+	// item names are looked up in any order for as long as the snapshot is used
+	snapshotFile.Advise(FileAccess::Mixed);
+	snapshot = move(snapshotFile);
+	loaded = true;
+	return true;
+}
+
+bool FrequencyEngine::Refresh()
+{
+	if (!loaded) {
+		return false;
+	}
+
+	// the path can be missing for a moment during rotation, keep the current counts
+	FileIdentity identity;
+	uint64_t size = 0;
+	int64_t modified = 0;
+	if (!StatFile(sourcePath, identity, size, modified)) {
+		return false;
+	}
+	if (identity != sourceIdentity || size < consumedBytes) {
+		return Load(sourcePath);
+	}
+	if (size == scannedBytes && modified == sourceModified) {
+		return true;
+	}
+
+	// read the checkpoint and everything after it, a file that is being truncated
+	// meanwhile only shortens the read where a mapping would fault
+	size_t base = consumedBytes - checkpoint.size();
+	ifstream input(sourcePath, ios::binary);
+	if (!input.is_open()) {
+		return false;
+	}
+	appended.resize(static_cast<size_t>(size) - base);
+	input.seekg(static_cast<streamoff>(base));
+	input.read(&appended[0], static_cast<streamsize>(appended.size()));
+	appended.resize(static_cast<size_t>(input.gcount()));
+
+	string_view text = appended;
+	if (text.size() < checkpoint.size() || text.substr(0, checkpoint.size()) != checkpoint) {
+		return Load(sourcePath);
+	}
+
+	// the partial last line is counted again with whatever was appended to it
+	if (tailCounted) {
+		Remove(tailItem);
+		tailCounted = false;
+	}
+	sourceModified = modified;
+	Consume(text, base, consumedBytes);
+	return true;
+}
+
+void FrequencyEngine::Consume(string_view text, size_t base, size_t offset)
+{
+	string_view fresh = text.substr(offset - base);
+	// chunk tables are exact and unbounded, the sketch is always filled on one thread
+	unsigned threads = sketch ? 1 : min<size_t>(threadCount, max<size_t>(fresh.size() / minimumChunkBytes, 1));
+	if (threads > 1) {
+		CountTextParallel(fresh, threads);
+	}
+	else {
+		CountText(fresh);
+	}
+
+	size_t lastNewline = fresh.rfind('\n');
+	size_t tailStart = lastNewline == string_view::npos ? offset : offset + lastNewline + 1;
+	string_view tail = Trim(text.substr(tailStart - base));
+	tailItem.assign(tail.data(), tail.size());
+	tailCounted = !tail.empty();
+
+	scannedBytes = base + text.size();
+	consumedBytes = tailStart;
+	// never reaches before base, consumedBytes only grows and the old checkpoint was read too
+	size_t keep = min(consumedBytes, checkpointBytes);
+	checkpoint.assign(text.substr(consumedBytes - keep - base, keep));
+}
+
+void FrequencyEngine::UseSketch(double epsilon)
+{
+	sketchError = epsilon;
+}
+
+void FrequencyEngine::SetThreadCount(unsigned threads)
+{
+	if (threads == 0) {
+		threads = max(thread::hardware_concurrency(), 1u);
+	}
+	threadCount = threads;
+}
+
+void FrequencyEngine::CountText(string_view text)
+{
+	ForEachLine(text, [this](string_view line) {
+		string_view item = Trim(line);
+		// blank lines are not items
+		if (!item.empty()) {
+			Add(item);
+		}
+	});
+}
+
+void FrequencyEngine::CountTextParallel(string_view text, unsigned threads)
+{
+	// cut points move forward to the next newline so no line is split between chunks
+	vector<string_view> chunks;
+	size_t begin = 0;
+	for (unsigned i = 1; i <= threads && begin < text.size(); i++) {
+		size_t end = text.size();
+		if (i < threads) {
+			end = max(begin, text.size() / threads * i);
+			end = text.find('\n', end);
+			end = end == string_view::npos ? text.size() : end + 1;
+		}
+		chunks.push_back(text.substr(begin, end - begin));
+		begin = end;
+	}
+
+	vector<ChunkCounts> partials(chunks.size());
+	vector<thread> workers;
+	for (size_t i = 0; i < chunks.size(); i++) {
+		workers.emplace_back([&chunks, &partials, i]() {
+			ChunkCounts& local = partials[i];
+			ForEachLine(chunks[i], [&local](string_view line) {
+				string_view item = Trim(line);
+				if (item.empty()) {
+					return;
+				}
+				auto found = local.index.find(item);
+				if (found != local.index.end()) {
+					local.counts[found->second] += 1;
+				}
+				else {
+					local.index.emplace(item, local.counts.size());
+					local.items.push_back(item);
+					local.counts.push_back(1);
+				}
+			});
+		});
+	}
+	for (thread& worker : workers) {
+		worker.join();
+	}
+
+	// merging chunks in file order keeps first-seen order identical to a sequential count
+	for (const ChunkCounts& local : partials) {
+		for (size_t i = 0; i < local.items.size(); i++) {
+			Add(local.items[i], local.counts[i]);
+		}
+	}
+}
+
+void FrequencyEngine::Add(string_view item, size_t amount)
+{
+	if (sketch) {
+		sketch->Add(item, amount);
+		return;
+	}
+
+	auto found = index.find(item);
+	if (found != index.end()) {
+		counts[found->second] += amount;
+		return;
+	}
+
+	// the key must view the owned copy, not the mapped line
+	ownedItems.emplace_back(item);
+	items.push_back(ownedItems.back());
+	index.emplace(items.back(), counts.size());
+	counts.push_back(amount);
+}
+
+void FrequencyEngine::Remove(string_view item)
+{
+	if (sketch) {
+		sketch->Remove(item);
+		return;
+	}
+
+	auto found = index.find(item);
+	if (found != index.end() && counts[found->second] > 0) {
+		counts[found->second] -= 1;
+	}
+}
+
+bool FrequencyEngine::IsLoaded() const
+{
+	return loaded;
+}
+
+size_t FrequencyEngine::CountOf(string_view name) const
+{
+	if (sketch) {
+		const SpaceSaving::Entry* entry = sketch->Find(name);
+		return entry == nullptr ? 0 : entry->count;
+	}
+
+	auto found = index.find(name);
+	return found == index.end() ? 0 : counts[found->second];
+}
+
+vector<size_t> FrequencyEngine::CountsOf(const vector<string_view>& names) const
+{
+	vector<size_t> found;
+	found.reserve(names.size());
+	for (string_view name : names) {
+		found.push_back(CountOf(name));
+	}
+	return found;
+}
+
+bool FrequencyEngine::PrintBatch(ReportWriter& out, const string& listPath) const
+{
+	MappedFile listFile;
+	if (!listFile.Open(listPath)) {
+		return false;
+	}
+
+	vector<string_view> names;
+	ForEachLine(listFile.View(), [&names](string_view line) {
+		string_view name = Trim(line);
+		if (!name.empty()) {
+			names.push_back(name);
+		}
+	});
+
+	vector<size_t> found = CountsOf(names);
+	for (size_t i = 0; i < names.size(); i++) {
+		out.CountRow(names[i], found[i]);
+	}
+	out.Flush();
+	return true;
+}
+
+vector<size_t> FrequencyEngine::RankedSlots(size_t limit, size_t threshold) const
+{
+	// filter before sorting so a high threshold only sorts the few items above it
+	vector<size_t> slots;
+	for (size_t i = 0; i < counts.size(); i++) {
+		if (counts[i] > threshold) {
+			slots.push_back(i);
+		}
+	}
+
+	// same order as Counter.most_common, ties stay in first-seen order
+	auto higher = [this](size_t a, size_t b) {
+		return counts[a] != counts[b] ? counts[a] > counts[b] : a < b;
+	};
+	if (limit < slots.size()) {
+		partial_sort(slots.begin(), slots.begin() + limit, slots.end(), higher);
+		slots.resize(limit);
+	}
+	else {
+		sort(slots.begin(), slots.end(), higher);
+	}
+	return slots;
+}
+
+void FrequencyEngine::PrintEntries(ReportWriter& out, const vector<const SpaceSaving::Entry*>& entries) const
+{
+	for (const SpaceSaving::Entry* entry : entries) {
+		out.EstimateRow(entry->item, entry->count, entry->error);
+	}
+	out.Flush();
+}
+
+void FrequencyEngine::PrintTop(ReportWriter& out, size_t k) const
+{
+	if (sketch) {
+		PrintEntries(out, sketch->Top(k));
+		return;
+	}
+
+	for (size_t slot : RankedSlots(k)) {
+		out.CountRow(items[slot], counts[slot]);
+	}
+	out.Flush();
+}
+
+void FrequencyEngine::PrintAbove(ReportWriter& out, size_t threshold) const
+{
+	if (sketch) {
+		PrintEntries(out, sketch->Above(threshold));
+		return;
+	}
+
+	for (size_t slot : RankedSlots(counts.size(), threshold)) {
+		out.CountRow(items[slot], counts[slot]);
+	}
+	out.Flush();
+}
+
+void FrequencyEngine::PrintFrequency(ReportWriter& out) const
+{
+	// the sketch has no first-seen order, report what it monitors highest first
+	if (sketch) {
+		PrintEntries(out, sketch->Top(sketch->Capacity()));
+		return;
+	}
+
+	for (size_t i = 0; i < items.size(); i++) {
+		if (counts[i] > 0) {
+			out.CountRow(items[i], counts[i]);
+		}
+	}
+	out.Flush();
+}
+
+void FrequencyEngine::PrintSpecific(ReportWriter& out, const string& name) const
+{
+	out.Line(name);
+	size_t count = CountOf(name);
+	if (count > 0) {
+		out.CountRow(name, count);
+	}
+	out.Flush();
+}
+
+void FrequencyEngine::PrintHistogram(ReportWriter& out) const
+{
+	if (sketch) {
+		vector<const SpaceSaving::Entry*> entries = sketch->Top(sketch->Capacity());
+		size_t maxCount = entries.empty() ? 0 : entries.front()->count;
+		for (const SpaceSaving::Entry* entry : entries) {
+			out.HistogramRow(entry->item, entry->count, maxCount);
+		}
+		out.Flush();
+		return;
+	}
+
+	size_t maxCount = counts.empty() ? 0 : *max_element(counts.begin(), counts.end());
+	for (size_t i = 0; i < items.size(); i++) {
+		if (counts[i] > 0) {
+			out.HistogramRow(items[i], counts[i], maxCount);
+		}
+	}
+	out.Flush();
+}
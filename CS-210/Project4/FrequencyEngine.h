@@ -0,0 +1,128 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../../Common/MappedFile.h"
+#include "ReportWriter.h"
+#include "SpaceSaving.h"
+
+/*
+Description:
+	Native replacement for the Python frequencyCounter. The source file is
+	memory mapped and split on newlines in place in a single pass, lines are
+	only copied the first time a distinct item is seen, and every menu query
+	afterwards is answered from memory.
+Example:
+	FrequencyEngine engine;
+	engine.Load("source.txt");
+	ReportWriter out(stdout);
+	engine.PrintFrequency(out);
+*/
+class FrequencyEngine
+{
+public:
+	// read and count the file, replacing any previously loaded counts
+	bool Load(const std::string& filePath);
+
+	// count only what was appended since the last Load or Refresh, reading just the
+	// new bytes; a rotated or truncated file is recounted from the start
+	bool Refresh();
+
+	// write the counts to a binary snapshot stamped with the source file size and
+	// modification time, exact counts only
+	bool SaveSnapshot(const std::string& snapshotPath) const;
+
+	// answer from a snapshot instead of counting filePath, item names stay in the
+	// mapped snapshot; false if it is missing, corrupt or the source has changed since
+	bool LoadSnapshot(const std::string& snapshotPath, const std::string& filePath);
+
+	// worker threads used by Load, 0 picks one per hardware thread
+	void SetThreadCount(unsigned threads);
+
+	// count into a fixed size Space-Saving sketch instead of the exact table, every
+	// reported count then overestimates by at most epsilon of the total, takes effect on Load
+	void UseSketch(double epsilon);
+
+	// true once a file has been counted
+	bool IsLoaded() const;
+
+	// occurrences of a single item, 0 if it was never seen
+	size_t CountOf(std::string_view name) const;
+
+	// counts for many items at once, one hashed lookup each, results in the order given
+	std::vector<size_t> CountsOf(const std::vector<std::string_view>& names) const;
+
+	// look up every item listed one per line in listPath and print "name :  count",
+	// items never seen print a count of 0
+	bool PrintBatch(ReportWriter& out, const std::string& listPath) const;
+
+	// print the k most frequent items, highest first
+	void PrintTop(ReportWriter& out, size_t k) const;
+
+	// print every item seen more than threshold times, highest first
+	void PrintAbove(ReportWriter& out, size_t threshold) const;
+
+	// print every item and its count in first-seen order, items with no
+	// complete occurrence (a partial last line that later changed) are skipped
+	void PrintFrequency(ReportWriter& out) const;
+
+	// print the searched name followed by its count when it exists
+	void PrintSpecific(ReportWriter& out, const std::string& name) const;
+
+	// print every item with a bar of '*', one per occurrence until the largest
+	// count no longer fits the report width, then scaled to it
+	void PrintHistogram(ReportWriter& out) const;
+
+private:
+	// count text from offset to the end and remember where the unterminated tail starts,
+	// text holds the file from byte base onwards
+	void Consume(std::string_view text, size_t base, size_t offset);
+
+	// count every line of text into the table
+	void CountText(std::string_view text);
+
+	// split text into newline aligned chunks, count each on its own thread and merge
+	void CountTextParallel(std::string_view text, unsigned threads);
+
+	// add occurrences of an already trimmed item
+	void Add(std::string_view item, size_t amount = 1);
+
+	// take back one occurrence of an item
+	void Remove(std::string_view item);
+
+	// at most limit exact slots counted above threshold, highest first, ties in first-seen order
+	std::vector<size_t> RankedSlots(size_t limit, size_t threshold = 0) const;
+
+	// print ranked sketch entries with their error
+	void PrintEntries(ReportWriter& out, const std::vector<const SpaceSaving::Entry*>& entries) const;
+
+	// forget every count and release the storage behind them
+	void Reset();
+
+	std::vector<std::string_view> items;	// distinct items in first-seen order
+	std::vector<size_t> counts;				// counts parallel to items
+	std::unordered_map<std::string_view, size_t> index;	// item -> slot in items/counts
+	std::deque<std::string> ownedItems;		// storage for items counted from text, deque keeps addresses stable
+	MappedFile snapshot;					// storage for items loaded from a snapshot
+	int64_t sourceModified = 0;				// source modification time when it was counted
+	std::unique_ptr<SpaceSaving> sketch;	// replaces the table above when set
+	double sketchError = 0.0;
+
+	// follow state, the unterminated last line is counted but recounted once it grows
+	std::string sourcePath;
+	FileIdentity sourceIdentity;
+	size_t scannedBytes = 0;		// file size at the last scan
+	size_t consumedBytes = 0;		// offset of the first byte after the last newline
+	std::string tailItem;			// item on the unterminated last line, counted once
+	bool tailCounted = false;
+	std::string checkpoint;			// bytes just before consumedBytes, detects rewritten files
+	std::string appended;			// checkpoint and new bytes read by Refresh, reused between calls
+
+	unsigned threadCount = 1;
+	bool loaded = false;
+};
@@ -0,0 +1,189 @@
+#include "PythonBridge.h"
+
+#include <iostream>
+
+using namespace std;
+
+PythonBridge::~PythonBridge()
+{
+	Close();
+}
+
+bool PythonBridge::Open(const string& sourcePath)
+{
+	if (IsOpen()) {
+		return true;
+	}
+
+	if (!Py_IsInitialized()) {
+		Py_Initialize();
+		initialized = true;
+	}
+
+	module = PyImport_ImportModule("PythonCode");
+	if (module == nullptr) {
+		PyErr_Print();
+		Close();
+		return false;
+	}
+
+	// a single counter instance serves every query of the session
+	PyObject* counterClass = PyObject_GetAttrString(module, "frequencyCounter");
+	if (counterClass != nullptr) {
+		counter = PyObject_CallFunction(counterClass, "s", sourcePath.c_str());
+		Py_DECREF(counterClass);
+	}
+	if (counter == nullptr) {
+		PyErr_Print();
+		Close();
+		return false;
+	}
+
+	printFrequency = CacheMethod("printFrequency");
+	printSpecific = CacheMethod("printSpecific");
+	printHistogram = CacheMethod("printHistogram");
+	printBatch = CacheMethod("printBatch");
+	printTop = CacheMethod("printTop");
+	printAbove = CacheMethod("printAbove");
+
+	// sys.stdout is buffered, flush it so Python output stays in order with cout
+	PyObject* pyStdout = PySys_GetObject("stdout");	// borrowed reference
+	if (pyStdout != nullptr) {
+		flushStdout = PyObject_GetAttrString(pyStdout, "flush");
+	}
+	PyErr_Clear();
+
+	if (printFrequency == nullptr || printSpecific == nullptr || printHistogram == nullptr
+		|| printBatch == nullptr || printTop == nullptr || printAbove == nullptr) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+bool PythonBridge::IsOpen() const
+{
+	return counter != nullptr;
+}
+
+void PythonBridge::Close()
+{
+	Py_CLEAR(flushStdout);
+	Py_CLEAR(printAbove);
+	Py_CLEAR(printTop);
+	Py_CLEAR(printBatch);
+	Py_CLEAR(printHistogram);
+	Py_CLEAR(printSpecific);
+	Py_CLEAR(printFrequency);
+	Py_CLEAR(counter);
+	Py_CLEAR(module);
+
+	if (initialized) {
+		Py_Finalize();
+		initialized = false;
+	}
+}
+
+PyObject* PythonBridge::CacheMethod(const char* name)
+{
+	PyObject* method = PyObject_GetAttrString(counter, name);
+	if (method == nullptr || !PyCallable_Check(method)) {
+		PyErr_Print();
+		Py_XDECREF(method);
+		return nullptr;
+	}
+	return method;
+}
+
+bool PythonBridge::Invoke(PyObject* callable, PyObject* args)
+{
+	cout.flush();
+
+	PyObject* result = PyObject_CallObject(callable, args);
+	bool status = result != nullptr;
+	if (!status) {
+		PyErr_Print();
+	}
+	Py_XDECREF(result);
+
+	if (flushStdout != nullptr) {
+		PyObject* flushed = PyObject_CallObject(flushStdout, NULL);
+		Py_XDECREF(flushed);
+		PyErr_Clear();
+	}
+	return status;
+}
+
+bool PythonBridge::PrintFrequency()
+{
+	return IsOpen() && Invoke(printFrequency, NULL);
+}
+
+bool PythonBridge::PrintSpecific(const string& name)
+{
+	if (!IsOpen()) {
+		return false;
+	}
+
+	PyObject* args = Py_BuildValue("(s)", name.c_str());
+	if (args == nullptr) {
+		PyErr_Print();
+		return false;
+	}
+	bool status = Invoke(printSpecific, args);
+	Py_DECREF(args);
+	return status;
+}
+
+bool PythonBridge::PrintHistogram()
+{
+	return IsOpen() && Invoke(printHistogram, NULL);
+}
+
+bool PythonBridge::PrintBatch(const string& listPath)
+{
+	if (!IsOpen()) {
+		return false;
+	}
+
+	PyObject* args = Py_BuildValue("(s)", listPath.c_str());
+	if (args == nullptr) {
+		PyErr_Print();
+		return false;
+	}
+	bool status = Invoke(printBatch, args);
+	Py_DECREF(args);
+	return status;
+}
+
+bool PythonBridge::PrintTop(size_t k)
+{
+	if (!IsOpen()) {
+		return false;
+	}
+
+	PyObject* args = Py_BuildValue("(n)", static_cast<Py_ssize_t>(k));
+	if (args == nullptr) {
+		PyErr_Print();
+		return false;
+	}
+	bool status = Invoke(printTop, args);
+	Py_DECREF(args);
+	return status;
+}
+
+bool PythonBridge::PrintAbove(size_t threshold)
+{
+	if (!IsOpen()) {
+		return false;
+	}
+
+	PyObject* args = Py_BuildValue("(n)", static_cast<Py_ssize_t>(threshold));
+	if (args == nullptr) {
+		PyErr_Print();
+		return false;
+	}
+	bool status = Invoke(printAbove, args);
+	Py_DECREF(args);
+	return status;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <Python.h>
+#include <string>
+
+/*
+Description:
+	Long lived session with the embedded Python interpreter. The runtime is
+	started once, PythonCode is imported once and a single frequencyCounter
+	instance is kept alive, with its bound methods cached as PyObject* so a
+	query is one call into Python instead of a full interpreter cycle.
+Example:
+	PythonBridge bridge;
+	if (bridge.Open("source.txt")) bridge.PrintFrequency();
+*/
+class PythonBridge
+{
+public:
+	PythonBridge() = default;
+	~PythonBridge();
+
+	// the bridge owns interpreter state and must not be copied
+	PythonBridge(const PythonBridge&) = delete;
+	PythonBridge& operator=(const PythonBridge&) = delete;
+
+	// start the interpreter and build the counter, safe to call repeatedly
+	bool Open(const std::string& sourcePath);
+
+	// true once the counter instance is available
+	bool IsOpen() const;
+
+	// release every cached object and shut the interpreter down
+	void Close();
+
+	// frequencyCounter.printFrequency()
+	bool PrintFrequency();
+
+	// frequencyCounter.printSpecific(name)
+	bool PrintSpecific(const std::string& name);
+
+	// frequencyCounter.printHistogram()
+	bool PrintHistogram();
+
+	// frequencyCounter.printBatch(listPath)
+	bool PrintBatch(const std::string& listPath);
+
+	// frequencyCounter.printTop(k)
+	bool PrintTop(size_t k);
+
+	// frequencyCounter.printAbove(threshold)
+	bool PrintAbove(size_t threshold);
+
+private:
+	// call a cached callable, releasing the result and flushing Python output
+	bool Invoke(PyObject* callable, PyObject* args);
+
+	// look up a bound method of the counter, returns a new reference
+	PyObject* CacheMethod(const char* name);
+
+	bool initialized = false;				// Py_Initialize was called by this bridge
+	PyObject* module = nullptr;				// PythonCode
+	PyObject* counter = nullptr;			// frequencyCounter(sourcePath)
+	PyObject* printFrequency = nullptr;		// bound counter.printFrequency
+	PyObject* printSpecific = nullptr;		// bound counter.printSpecific
+	PyObject* printHistogram = nullptr;		// bound counter.printHistogram
+	PyObject* printBatch = nullptr;			// bound counter.printBatch
+	PyObject* printTop = nullptr;			// bound counter.printTop
+	PyObject* printAbove = nullptr;			// bound counter.printAbove
+	PyObject* flushStdout = nullptr;		// bound sys.stdout.flush
+};
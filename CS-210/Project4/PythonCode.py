@@ -1,11 +1,15 @@
 from collections import Counter
 
+# widest histogram bar, longer bars are scaled to fit
+HISTOGRAM_WIDTH = 60
+
 #class to automatically read file and collect info
 class frequencyCounter:
     def __init__(self, file):
         self.filePath = file
-        self.file = open(self.filePath, 'r')
-        self.lines = self.file.readlines()
+        # strip line endings and skip blank lines so counts match the native engine
+        with open(self.filePath, 'r') as self.file:
+            self.lines = [line.strip() for line in self.file if line.strip()]
         self.calculateFrequency()
 
     def calculateFrequency(self):
@@ -14,19 +18,42 @@ class frequencyCounter:
 
     def printFrequency(self):
         for count in self.counts:
-            print(count.strip(), ": ", self.counts[count])
+            print(count, ": ", self.counts[count])
     
 
     def printSpecific(self, name):
         print(name)
-        for count in self.counts:
-            if count.strip() == name:
-                print(count.strip(), ": ", self.counts[count])
+        if name in self.counts:
+            print(name, ": ", self.counts[name])
 
     
     def printHistogram(self):
+        largest = max(self.counts.values(), default=0)
         for count in self.counts:
-            print (count.strip(), ": ", ''.ljust(self.counts[count], '*'))
+            bar = self.counts[count]
+            if largest > HISTOGRAM_WIDTH:
+                bar = -(-bar * HISTOGRAM_WIDTH // largest)
+            print (count, ": ", ''.ljust(bar, '*'))
+
+
+    def printBatch(self, listPath):
+        with open(listPath, 'r') as names:
+            for name in names:
+                name = name.strip()
+                if name:
+                    print(name, ": ", self.counts[name])
+
+
+    def printTop(self, k):
+        for name, count in self.counts.most_common(k):
+            print(name, ": ", count)
+
+
+    def printAbove(self, threshold):
+        for name, count in self.counts.most_common():
+            if count <= threshold:
+                break
+            print(name, ": ", count)
 
             
 #public links to class
@@ -36,7 +63,6 @@ def GetFrequency():
 
 
 def findSpecific(name):
-    print(name);
     freq = frequencyCounter('source.txt')
     freq.printSpecific(name)
 
@@ -45,3 +71,17 @@ def getHistogram():
     freq = frequencyCounter('source.txt')
     freq.printHistogram()
 
+
+def getTop(k):
+    freq = frequencyCounter('source.txt')
+    freq.printTop(k)
+
+
+def getAbove(threshold):
+    freq = frequencyCounter('source.txt')
+    freq.printAbove(threshold)
+
+
+def findBatch(listPath):
+    freq = frequencyCounter('source.txt')
+    freq.printBatch(listPath)
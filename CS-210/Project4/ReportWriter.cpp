@@ -0,0 +1,52 @@
+#include "ReportWriter.h"
+
+using namespace std;
+
+ReportWriter::ReportWriter(FILE* target, size_t barWidth)
+	: BufferedWriter(target), barWidth(barWidth == 0 ? defaultBarWidth : barWidth)
+{
+}
+
+void ReportWriter::CountRow(string_view item, size_t count)
+{
+	Write(item);
+	Write(" :  ");
+	WriteNumber(count);
+	Write('\n');
+}
+
+void ReportWriter::EstimateRow(string_view item, size_t count, size_t error)
+{
+	Write(item);
+	Write(" :  ");
+	WriteNumber(count);
+	if (error > 0) {
+		Write(" (at most ");
+		WriteNumber(error);
+		Write(" over)");
+	}
+	Write('\n');
+}
+
+void ReportWriter::HistogramRow(string_view item, size_t count, size_t maxCount)
+{
+	Write(item);
+	Write(" :  ");
+	WriteRepeated('*', BarLength(count, maxCount));
+	Write('\n');
+}
+
+size_t ReportWriter::BarLength(size_t count, size_t maxCount) const
+{
+	if (maxCount <= barWidth) {
+		return count;
+	}
+	// round up so every item that was seen keeps at least one '*'
+	return static_cast<size_t>((static_cast<unsigned long long>(count) * barWidth + maxCount - 1) / maxCount);
+}
+
+void ReportWriter::Line(string_view text)
+{
+	Write(text);
+	Write('\n');
+}
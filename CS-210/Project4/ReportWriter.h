@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdio>
+#include <string_view>
+
+#include "../../Common/BufferedWriter.h"
+
+/*
+Description:
+	Formats frequency and histogram rows into the shared output buffer.
+	Histogram bars are scaled so the most frequent item fills barWidth
+	characters, counts that already fit are drawn one '*' per occurrence.
+Example:
+	ReportWriter out(stdout);
+	out.CountRow("Peas", 8);
+	out.HistogramRow("Peas", 8, 10);
+	out.Flush();
+*/
+class ReportWriter : public BufferedWriter
+{
+public:
+	static const size_t defaultBarWidth = 60;
+
+	explicit ReportWriter(FILE* target = stdout, size_t barWidth = defaultBarWidth);
+
+	// "item :  count"
+	void CountRow(std::string_view item, size_t count);
+
+	// "item :  count (at most error over)" for approximate counts
+	void EstimateRow(std::string_view item, size_t count, size_t error);
+
+	// "item :  ****" scaled against the largest count in the report
+	void HistogramRow(std::string_view item, size_t count, size_t maxCount);
+
+	// bar length for count when the largest count is maxCount
+	size_t BarLength(size_t count, size_t maxCount) const;
+
+	// a line of text
+	void Line(std::string_view text);
+
+private:
+	size_t barWidth;
+};
@@ -1,87 +1,23 @@
-#include <Python.h>
 #include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <Windows.h>
 #include <cmath>
 #include <string>
 #include <sstream>
 #undef max	// old macro workaround for numeric_limits
 
-using namespace std;
+#include "FrequencyEngine.h"
+#include "PythonBridge.h"
 
-/*
-Description:
-	To call this function, simply pass the function name in Python that you wish to call.
-Example:
-	callProcedure("printsomething");
-Output:
-	Python will print on the screen: Hello from python!
-Return:
-	None
-*/
-void CallProcedure(string pName)
-{
-	char* procname = new char[pName.length() + 1];
-	std::strcpy(procname, pName.c_str());
+using namespace std;
 
-	Py_Initialize();
-	PyObject* my_module = PyImport_ImportModule("PythonCode");
-	PyErr_Print();
-	PyObject* my_function = PyObject_GetAttrString(my_module, procname);
-	PyObject* my_result = PyObject_CallObject(my_function, NULL);
-	Py_Finalize();
+// data file shared by the native engine and PythonCode.py
+const string sourceFile = "source.txt";
 
-	delete[] procname;
-}
-
-/*
-Description:
-	To call this function, pass the name of the Python functino you wish to call and the string parameter you want to send
-Example:
-	int x = callIntFunc("doublevalue",5);
-Return:
-	25 is returned to the C++
-*/
-void callStrFunc(string proc, string param)
-{
-	char* procname = new char[proc.length() + 1];
-	std::strcpy(procname, proc.c_str());
-
-	char* paramval = new char[param.length() + 1];
-	std::strcpy(paramval, param.c_str());
-
-	PyObject* pName, * pModule, * pDict, * pFunc, * pValue = nullptr, * presult = nullptr;
-	// Initialize the Python Interpreter
-	Py_Initialize();
-	// Build the name object
-	//pName = PyUnicode_FromString((char*)"PythonCode"); // fails to find file every time
-	// Load the module object
-	pModule = PyImport_ImportModule("PythonCode");
-	// pDict is a borrowed reference 
-	pDict = PyModule_GetDict(pModule);
-	// pFunc is also a borrowed reference 
-	pFunc = PyDict_GetItemString(pDict, procname);
-	if (PyCallable_Check(pFunc))
-	{
-		pValue = Py_BuildValue("(z)", paramval);
-		PyErr_Print();
-		presult = PyObject_CallObject(pFunc, pValue);
-		PyErr_Print();
-	}
-	else
-	{
-		PyErr_Print();
-	}
-	//printf("Result is %d\n", _PyLong_AsInt(presult));
-	Py_DECREF(pValue);
-	// Clean up
-	Py_DECREF(pModule);
-	//Py_DECREF(pName); //no longer needed
-	// Finish the Python Interpreter
-	Py_Finalize();
-
-	// clean 
-	delete[] procname;
-}
+// precomputed counts for sourceFile, reused while the source is unchanged
+const string snapshotFile = "source.txt.snapshot";
 
 template<typename T>
 T& validateString(T& val, string message)
@@ -119,10 +55,106 @@ T& validateInt(T& val, string message)
 	return val;
 }
 
-void main()
+/*
+Description:
+	Loads the native engine on first use so the source file is only read once per run.
+	A current snapshot is used instead of counting, otherwise the fresh count is saved as one.
+	In follow mode later calls pick up only the lines appended since the last query.
+Return:
+	true if the engine holds counts for the source file
+*/
+bool EnsureLoaded(FrequencyEngine& engine, bool follow, bool useSnapshot)
+{
+	if (engine.IsLoaded()) {
+		if (follow) {
+			engine.Refresh();
+		}
+	}
+	else if (useSnapshot && engine.LoadSnapshot(snapshotFile, sourceFile)) {
+		// counts came straight from the snapshot
+	}
+	else if (!engine.Load(sourceFile)) {
+		cout << "Unable to open " << sourceFile << endl;
+	}
+	else if (useSnapshot) {
+		engine.SaveSnapshot(snapshotFile);
+	}
+	return engine.IsLoaded();
+}
+
+/*
+Description:
+	Opens the Python session on first use, the interpreter then stays up for the rest of the run.
+Return:
+	true if the bridge is ready for queries
+*/
+bool EnsureOpen(PythonBridge& bridge)
+{
+	if (!bridge.IsOpen() && !bridge.Open(sourceFile)) {
+		cout << "Unable to start the Python back end" << endl;
+	}
+	return bridge.IsOpen();
+}
+
+/*
+Description:
+	Menu entry point. The native engine answers every query by default,
+	pass --python to route the menu through PythonCode.py instead.
+	--threads N counts large files on N threads, 0 uses every core.
+	--follow keeps counting lines appended to source.txt between queries.
+	--sketch E counts in fixed memory, reported counts may be over by E of the total.
+	--lookup FILE prints the count of every item listed in FILE and exits.
+	--no-snapshot always counts source.txt instead of using source.txt.snapshot.
+	--report FILE writes native reports to FILE instead of the console.
+*/
+int main(int argc, char* argv[])
 {
 	bool exitState = false;
+	bool usePython = false;
+	bool follow = false;
+	bool useSnapshot = true;
+	string lookupFile = "";
 	int userIn;
+	FrequencyEngine engine;
+	PythonBridge bridge;
+	ReportWriter report(stdout);
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--python") == 0) {
+			usePython = true;
+		}
+		else if (strcmp(argv[i], "--follow") == 0) {
+			follow = true;
+		}
+		else if (strcmp(argv[i], "--no-snapshot") == 0) {
+			useSnapshot = false;
+		}
+		else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) {
+			if (!report.Open(argv[++i])) {
+				cout << "Unable to write " << argv[i] << endl;
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "--lookup") == 0 && i + 1 < argc) {
+			lookupFile = argv[++i];
+		}
+		else if (strcmp(argv[i], "--sketch") == 0 && i + 1 < argc) {
+			engine.UseSketch(atof(argv[++i]));
+		}
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			engine.SetThreadCount(static_cast<unsigned>(atoi(argv[++i])));
+		}
+	}
+
+	// non-interactive reconciliation run, one pass over the list
+	if (!lookupFile.empty()) {
+		bool found = usePython ? EnsureOpen(bridge) && bridge.PrintBatch(lookupFile)
+			: EnsureLoaded(engine, follow, useSnapshot) && engine.PrintBatch(report, lookupFile);
+		if (!found) {
+			cout << "Unable to read " << lookupFile << endl;
+		}
+		return found ? 0 : 1;
+	}
 
 	do {
 
@@ -130,23 +162,81 @@ void main()
 		cout << "2: Find ocurance of specific word" << endl;
 		cout << "3: Histogram of Frequency" << endl;
 		cout << "4: Exit" << endl;
-		userIn = validateInt(userIn, "Enter your selection as a number 1, 2, or 3, 4.");
+		cout << "5: Most frequent items" << endl;
+		cout << "6: Items seen more than N times" << endl;
+		cout << "7: Look up a list of items from a file" << endl;
+		userIn = validateInt(userIn, "Enter your selection as a number 1 through 7.");
 		string userval = "";
+		int limit = 0;
 
 		switch (userIn) {
 		case 1:
-			CallProcedure("GetFrequency");
+			if (usePython) {
+				if (EnsureOpen(bridge)) {
+					bridge.PrintFrequency();
+				}
+			}
+			else if (EnsureLoaded(engine, follow, useSnapshot)) {
+				engine.PrintFrequency(report);
+			}
 			break;
 		case 2:
 			userval = validateString(userval, "Enter in name to search");
-			callStrFunc("findSpecific", userval);
+			if (usePython) {
+				if (EnsureOpen(bridge)) {
+					bridge.PrintSpecific(userval);
+				}
+			}
+			else if (EnsureLoaded(engine, follow, useSnapshot)) {
+				engine.PrintSpecific(report, userval);
+			}
 			break;
 		case 3:
-			CallProcedure("getHistogram");
+			if (usePython) {
+				if (EnsureOpen(bridge)) {
+					bridge.PrintHistogram();
+				}
+			}
+			else if (EnsureLoaded(engine, follow, useSnapshot)) {
+				engine.PrintHistogram(report);
+			}
 			break;
 		case 4:
 			exitState = true;
 			break;
+		case 5:
+			limit = validateInt(limit, "How many items?");
+			if (usePython) {
+				if (EnsureOpen(bridge)) {
+					bridge.PrintTop(static_cast<size_t>(max(limit, 0)));
+				}
+			}
+			else if (EnsureLoaded(engine, follow, useSnapshot)) {
+				engine.PrintTop(report, static_cast<size_t>(max(limit, 0)));
+			}
+			break;
+		case 6:
+			limit = validateInt(limit, "Show items seen more than how many times?");
+			if (usePython) {
+				if (EnsureOpen(bridge)) {
+					bridge.PrintAbove(static_cast<size_t>(max(limit, 0)));
+				}
+			}
+			else if (EnsureLoaded(engine, follow, useSnapshot)) {
+				engine.PrintAbove(report, static_cast<size_t>(max(limit, 0)));
+			}
+			break;
+		case 7:
+			userval = validateString(userval, "Enter the path of the item list");
+			if (usePython) {
+				if (EnsureOpen(bridge) && !bridge.PrintBatch(userval)) {
+					cout << "Unable to read " << userval << endl;
+				}
+			}
+			else if (EnsureLoaded(engine, follow, useSnapshot) && !engine.PrintBatch(report, userval)) {
+				cout << "Unable to read " << userval << endl;
+			}
+			break;
 		default:
 			//final safe guard
 			cout << " Did not recognize input: " << userIn << "please try again" << endl;
@@ -154,5 +244,5 @@ void main()
 
 	} while (!exitState);
 
-
-}
\ No newline at end of file
+	return 0;
+}
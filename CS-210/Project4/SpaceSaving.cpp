@@ -0,0 +1,149 @@
+#include "SpaceSaving.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+SpaceSaving::SpaceSaving(size_t capacity)
+	: capacity(max<size_t>(capacity, 1))
+{
+	entries.reserve(this->capacity);
+	heap.reserve(this->capacity);
+	heapPosition.reserve(this->capacity);
+	index.reserve(this->capacity);
+}
+
+size_t SpaceSaving::CapacityForError(double epsilon)
+{
+	if (!(epsilon > 0.0) || epsilon >= 1.0) {
+		return 1;
+	}
+	return static_cast<size_t>(ceil(1.0 / epsilon));
+}
+
+void SpaceSaving::Add(string_view item, size_t amount)
+{
+	auto found = index.find(item);
+	if (found != index.end()) {
+		entries[found->second].count += amount;
+		SiftDown(heapPosition[found->second]);
+		return;
+	}
+
+	if (entries.size() < capacity) {
+		size_t slot = entries.size();
+		entries.push_back(Entry{ string(item), amount, 0 });
+		index.emplace(entries[slot].item, slot);
+		heap.push_back(slot);
+		heapPosition.push_back(heap.size() - 1);
+		SiftUp(heap.size() - 1);
+		return;
+	}
+
+	// evict the smallest counter, the newcomer inherits its count as error
+	size_t slot = heap.front();
+	Entry& entry = entries[slot];
+	index.erase(entry.item);
+	entry.error = entry.count;
+	entry.count += amount;
+	entry.item.assign(item.data(), item.size());
+	index.emplace(entry.item, slot);
+	SiftDown(0);
+}
+
+void SpaceSaving::Remove(string_view item)
+{
+	auto found = index.find(item);
+	if (found == index.end()) {
+		return;
+	}
+
+	Entry& entry = entries[found->second];
+	if (entry.count > entry.error) {
+		entry.count -= 1;
+		SiftUp(heapPosition[found->second]);
+	}
+}
+
+const SpaceSaving::Entry* SpaceSaving::Find(string_view item) const
+{
+	auto found = index.find(item);
+	return found == index.end() ? nullptr : &entries[found->second];
+}
+
+vector<const SpaceSaving::Entry*> SpaceSaving::Ranked(size_t limit, size_t threshold) const
+{
+	vector<const Entry*> ranked;
+	for (const Entry& entry : entries) {
+		if (entry.count > threshold) {
+			ranked.push_back(&entry);
+		}
+	}
+
+	auto higher = [](const Entry* a, const Entry* b) {
+		return a->count != b->count ? a->count > b->count : a->item < b->item;
+	};
+	if (limit < ranked.size()) {
+		partial_sort(ranked.begin(), ranked.begin() + limit, ranked.end(), higher);
+		ranked.resize(limit);
+	}
+	else {
+		sort(ranked.begin(), ranked.end(), higher);
+	}
+	return ranked;
+}
+
+vector<const SpaceSaving::Entry*> SpaceSaving::Top(size_t k) const
+{
+	return Ranked(k, 0);
+}
+
+vector<const SpaceSaving::Entry*> SpaceSaving::Above(size_t threshold) const
+{
+	return Ranked(entries.size(), threshold);
+}
+
+size_t SpaceSaving::Capacity() const
+{
+	return capacity;
+}
+
+void SpaceSaving::SwapHeap(size_t a, size_t b)
+{
+	swap(heap[a], heap[b]);
+	heapPosition[heap[a]] = a;
+	heapPosition[heap[b]] = b;
+}
+
+void SpaceSaving::SiftUp(size_t position)
+{
+	while (position > 0) {
+		size_t parent = (position - 1) / 2;
+		if (entries[heap[parent]].count <= entries[heap[position]].count) {
+			break;
+		}
+		SwapHeap(parent, position);
+		position = parent;
+	}
+}
+
+void SpaceSaving::SiftDown(size_t position)
+{
+	while (true) {
+		size_t smallest = position;
+		size_t left = position * 2 + 1;
+		size_t right = left + 1;
+		if (left < heap.size() && entries[heap[left]].count < entries[heap[smallest]].count) {
+			smallest = left;
+		}
+		if (right < heap.size() && entries[heap[right]].count < entries[heap[smallest]].count) {
+			smallest = right;
+		}
+		if (smallest == position) {
+			return;
+		}
+		SwapHeap(position, smallest);
+		position = smallest;
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*
+Description:
+	Space-Saving heavy hitter sketch. At most capacity items are monitored at
+	once; when a new item arrives and the sketch is full it replaces the item
+	with the smallest count and inherits that count as its error. Every
+	estimate overestimates the true count by at most total / capacity, total
+	being all occurrences added, so a capacity of ceil(1 / epsilon) bounds the
+	error to epsilon * total.
+Example:
+	SpaceSaving sketch(SpaceSaving::CapacityForError(0.001));
+	sketch.Add("Peas");
+	vector<const SpaceSaving::Entry*> top = sketch.Top(10);
+*/
+class SpaceSaving
+{
+public:
+	struct Entry
+	{
+		std::string item;
+		size_t count = 0;	// estimated count, never below the true count
+		size_t error = 0;	// the true count is at least count - error
+	};
+
+	explicit SpaceSaving(size_t capacity);
+
+	// counters needed to keep the error within epsilon of the total
+	static size_t CapacityForError(double epsilon);
+
+	// add occurrences of an item
+	void Add(std::string_view item, size_t amount = 1);
+
+	// take back one occurrence of a monitored item, ignored once it was evicted
+	void Remove(std::string_view item);
+
+	// estimated entry for an item, nullptr when it is not monitored
+	const Entry* Find(std::string_view item) const;
+
+	// the k largest estimates, highest first, valid until the next Add or Remove
+	std::vector<const Entry*> Top(size_t k) const;
+
+	// monitored items whose estimate is above threshold, highest first,
+	// valid until the next Add or Remove
+	std::vector<const Entry*> Above(size_t threshold) const;
+
+	size_t Capacity() const;
+
+private:
+	// restore heap order around position after its count changed
+	void SiftUp(size_t position);
+	void SiftDown(size_t position);
+	void SwapHeap(size_t a, size_t b);
+
+	// at most limit entries estimated above threshold, highest first, ties by item
+	std::vector<const Entry*> Ranked(size_t limit, size_t threshold) const;
+
+	size_t capacity;
+	std::vector<Entry> entries;			// reserved up front so views into item stay valid
+	std::vector<size_t> heap;			// entry slots, smallest count on top
+	std::vector<size_t> heapPosition;	// entry slot -> position in heap
+	std::unordered_map<std::string_view, size_t> index;	// views into entries -> slot
+};
@@ -0,0 +1,269 @@
+/*
+ * Program Name: Course Planner Benchmark
+ * Author: Matthew Courts
+ * Description: generates synthetic course catalogs with a layered prerequisite
+ * DAG and times each planner stage at growing catalog sizes, reporting
+ * throughput per stage and the peak resident set size after each size
+ *
+ * Build: g++ -std=c++17 -O2 -pthread PlannerBench.cpp ../Source/CatalogLoader.cpp
+ *        ../Source/CourseCatalog.cpp ../Source/StringPool.cpp ../Source/PrerequisiteGraph.cpp
+ *        ../Source/ClosureMatrix.cpp ../Source/CatalogImage.cpp ../../Common/MappedFile.cpp -o PlannerBench
+ * Usage: PlannerBench [max courses] [depth] [fan-out] [scratch file]
+ *        sizes run in powers of ten from 100 up to max courses (default 1000000,
+ *        pass 10000000 for the largest size, which needs about 2.5 GB)
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+#include "../Source/CatalogLoader.h"
+#include "../Source/ClosureMatrix.h"
+#include "../Source/CourseCatalog.h"
+#include "../Source/PrerequisiteGraph.h"
+
+using namespace std;
+
+// the closure matrix is courses^2 / 8 bytes, larger catalogs sample the graph walk instead
+const size_t closureMatrixLimit = 20000;
+const size_t closureSamples = 1000;
+const size_t lookupCount = 1000000;
+const size_t lookupIds = 4096;
+
+/**
+ * Small deterministic generator so every run sees the same catalogs
+ */
+struct Random
+{
+    uint64_t state;
+
+    uint32_t Next(uint32_t bound)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<uint32_t>((state >> 33) % bound);
+    }
+};
+
+/**
+ * Id of generated course i
+ */
+string CourseId(size_t course)
+{
+    char id[24];
+    snprintf(id, sizeof(id), "SYN%07zu", course);
+    return id;
+}
+
+/**
+ * Writes a catalog whose courses are split into depth layers. Every course
+ * past the first layer takes one prerequisite from the layer right below it,
+ * so the longest chain is depth courses, plus up to fanOut - 1 more from any
+ * lower layer. Courses are written in a shuffled order so load order and id
+ * order differ, as in real data.
+ *
+ * @param path file to write
+ * @param courses number of courses
+ * @param depth number of layers
+ * @param fanOut most prerequisites per course
+ * @return status if the file was written
+ */
+bool GenerateCatalog(const string &path, size_t courses, size_t depth, size_t fanOut)
+{
+    static const char *const words[] = {"Introduction", "Advanced", "Data", "Structures", "Algorithms",
+                                        "Operating", "Systems", "Programming", "Networks", "Databases",
+                                        "Theory", "Discrete", "Mathematics", "Software", "Design", "Analysis"};
+    const size_t wordCount = sizeof(words) / sizeof(words[0]);
+    Random random{2024};
+
+    vector<size_t> order(courses);
+    for (size_t course = 0; course < courses; course++)
+    {
+        order[course] = course;
+    }
+    for (size_t course = courses; course > 1; course--)
+    {
+        swap(order[course - 1], order[random.Next(static_cast<uint32_t>(course))]);
+    }
+
+    FILE *file = nullptr;
+#ifdef _MSC_VER
+    fopen_s(&file, path.c_str(), "wb");
+#else
+    file = fopen(path.c_str(), "wb");
+#endif
+    if (file == nullptr)
+    {
+        return false;
+    }
+    size_t layerSize = (courses + depth - 1) / depth;
+    string line;
+    for (size_t course : order)
+    {
+        size_t layer = course / layerSize;
+        line = CourseId(course);
+        line += ',';
+        line += words[random.Next(wordCount)];
+        line += ' ';
+        line += words[random.Next(wordCount)];
+        line += ' ';
+        line += to_string(course);
+        if (layer > 0)
+        {
+            size_t below = (layer - 1) * layerSize;
+            line += ',';
+            line += CourseId(below + random.Next(static_cast<uint32_t>(layerSize)));
+            size_t extra = random.Next(static_cast<uint32_t>(fanOut));
+            for (size_t prereq = 0; prereq < extra; prereq++)
+            {
+                line += ',';
+                line += CourseId(random.Next(static_cast<uint32_t>(layer * layerSize)));
+            }
+        }
+        line += '\n';
+        fwrite(line.data(), 1, line.size(), file);
+    }
+    fclose(file);
+    return true;
+}
+
+/**
+ * @return peak resident set size of the process in megabytes
+ */
+double PeakResidentMegabytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return static_cast<double>(counters.PeakWorkingSetSize) / (1024.0 * 1024.0);
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0);
+#else
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;
+#endif
+#endif
+}
+
+template <typename Stage>
+double Seconds(Stage stage)
+{
+    auto start = chrono::steady_clock::now();
+    stage();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Prints one row of the results table
+ *
+ * @param stage name of the stage
+ * @param seconds time taken
+ * @param items work items handled, courses unless noted by unit
+ * @param unit name of a work item
+ */
+void PrintStage(const char *stage, double seconds, size_t items, const char *unit)
+{
+    printf("  %-12s %10.3f ms %14.0f %s/s\n", stage, seconds * 1000.0, items / seconds, unit);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t maxCourses = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    size_t depth = argc > 2 ? strtoull(argv[2], nullptr, 10) : 12;
+    size_t fanOut = argc > 3 ? strtoull(argv[3], nullptr, 10) : 4;
+    string path = argc > 4 ? argv[4] : "planner_bench.csv";
+    depth = depth == 0 ? 1 : depth;
+    fanOut = fanOut == 0 ? 1 : fanOut;
+
+    for (size_t courses = 100; courses <= maxCourses; courses *= 10)
+    {
+        if (!GenerateCatalog(path, courses, depth, fanOut))
+        {
+            fprintf(stderr, "Could not write %s\n", path.c_str());
+            return 1;
+        }
+        printf("%zu courses, depth %zu, fan-out %zu\n", courses, depth, fanOut);
+
+        CourseCatalog catalog;
+        PrerequisiteGraph graph;
+        ClosureMatrix closureMatrix;
+        vector<string> missing;
+        bool loaded = false;
+
+        PrintStage("load", Seconds([&]()
+                                   { loaded = LoadCatalogFile(path, catalog); }),
+                   courses, "courses");
+        if (!loaded || catalog.Size() != courses)
+        {
+            fprintf(stderr, "Loaded %zu of %zu courses\n", catalog.Size(), courses);
+            return 1;
+        }
+        PrintStage("validate", Seconds([&]()
+                                       { catalog.ValidatePrerequisites(missing); }),
+                   courses, "courses");
+        PrintStage("graph", Seconds([&]()
+                                    { graph.Build(catalog); }),
+                   courses, "courses");
+        PrintStage("sort by id", Seconds([&]()
+                                         { catalog.SortedView(CourseOrder::ById); }),
+                   courses, "courses");
+        PrintStage("sort by name", Seconds([&]()
+                                           { catalog.SortedView(CourseOrder::ByName); }),
+                   courses, "courses");
+
+        // ids are built up front so only the lookups are timed
+        Random random{7};
+        vector<string> ids(lookupIds);
+        for (string &id : ids)
+        {
+            id = CourseId(random.Next(static_cast<uint32_t>(courses)));
+        }
+        size_t found = 0;
+        PrintStage("lookup", Seconds([&]()
+                                     {
+                                         for (size_t lookup = 0; lookup < lookupCount; lookup++)
+                                         {
+                                             found += catalog.Find(ids[lookup % ids.size()]) != nullptr;
+                                         } }),
+                   lookupCount, "lookups");
+
+        vector<uint32_t> closure;
+        size_t closureItems = 0;
+        PrintStage("closure walk", Seconds([&]()
+                                           {
+                                               for (size_t sample = 0; sample < closureSamples; sample++)
+                                               {
+                                                   graph.PrerequisiteClosure(random.Next(static_cast<uint32_t>(courses)), closure);
+                                                   closureItems += closure.size();
+                                               } }),
+                   closureSamples, "queries");
+        if (courses <= closureMatrixLimit)
+        {
+            PrintStage("closure rows", Seconds([&]()
+                                               { closureMatrix.Build(graph); }),
+                       courses, "courses");
+        }
+        else
+        {
+            printf("  %-12s skipped, would need %.0f MB\n", "closure rows", courses / 8.0 * courses / (1024.0 * 1024.0));
+        }
+
+        printf("  catalog %.1f MB, peak RSS %.1f MB, %zu missing, %zu found, %zu closure entries\n\n",
+               catalog.MemoryBytes() / (1024.0 * 1024.0), PeakResidentMegabytes(), missing.size(), found, closureItems);
+    }
+
+    remove(path.c_str());
+    return 0;
+}
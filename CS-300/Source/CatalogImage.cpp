@@ -0,0 +1,165 @@
+/*
+ * Program Name: Course Planner
+ * Author: Matthew Courts
+ * Description: precompiled binary catalog images
+ */
+
+#include "CatalogImage.h"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+namespace
+{
+    const size_t sectionAlignment = 8;
+
+    size_t AlignUp(size_t offset)
+    {
+        return (offset + sectionAlignment - 1) & ~(sectionAlignment - 1);
+    }
+}
+
+bool IsCatalogImage(string_view text)
+{
+    return text.size() >= sizeof(imageMagic) && memcmp(text.data(), imageMagic, sizeof(imageMagic)) == 0;
+}
+
+bool ValidOffsets(const FlatArray<uint32_t> &offsets, size_t count)
+{
+    if (offsets.empty() || offsets[0] != 0 || offsets.back() != count)
+    {
+        return false;
+    }
+    for (size_t run = 1; run < offsets.size(); run++)
+    {
+        if (offsets[run] < offsets[run - 1])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AllBelow(const FlatArray<uint32_t> &values, size_t limit)
+{
+    for (uint32_t value : values)
+    {
+        if (value >= limit)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ImageWriter::Write(const string &path) const
+{
+    ImageHeader header = {};
+    memcpy(header.magic, imageMagic, sizeof(imageMagic));
+    header.version = imageVersion;
+    header.byteOrder = imageByteOrder;
+    header.sectionCount = static_cast<uint32_t>(sections.size());
+
+    vector<ImageSection> table(sections.size());
+    size_t offset = AlignUp(sizeof(ImageHeader) + table.size() * sizeof(ImageSection));
+    for (size_t section = 0; section < sections.size(); section++)
+    {
+        table[section].offset = offset;
+        table[section].bytes = sections[section].bytes;
+        table[section].elementSize = sections[section].elementSize;
+        table[section].reserved = 0;
+        offset = AlignUp(offset + sections[section].bytes);
+    }
+    header.fileSize = offset;
+
+    // write beside the target and rename, a planner may still have the old image mapped
+    string partialPath = path + ".tmp";
+    FILE *file = nullptr;
+#ifdef _MSC_VER
+    fopen_s(&file, partialPath.c_str(), "wb");
+#else
+    file = fopen(partialPath.c_str(), "wb");
+#endif
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    // stop at the first short write, so written is exact and padding stays within the alignment
+    static const char padding[sectionAlignment] = {};
+    bool complete = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                    fwrite(table.data(), sizeof(ImageSection), table.size(), file) == table.size();
+    size_t written = sizeof(header) + table.size() * sizeof(ImageSection);
+    for (size_t section = 0; complete && section <= sections.size(); section++)
+    {
+        size_t start = section < sections.size() ? table[section].offset : header.fileSize;
+        complete = fwrite(padding, 1, start - written, file) == start - written;
+        written = start;
+        if (complete && section < sections.size() && sections[section].bytes > 0)
+        {
+            complete = fwrite(sections[section].data, 1, sections[section].bytes, file) == sections[section].bytes;
+            written += sections[section].bytes;
+        }
+    }
+    bool flushed = fflush(file) == 0;
+    bool closed = fclose(file) == 0;
+    if (!complete || !flushed || !closed)
+    {
+        remove(partialPath.c_str());
+        return false;
+    }
+
+    remove(path.c_str());
+    return rename(partialPath.c_str(), path.c_str()) == 0;
+}
+
+bool ImageReader::Open(string_view text)
+{
+    image = text;
+    sections = nullptr;
+    sectionCount = 0;
+    nextSection = 0;
+
+    if (!IsCatalogImage(image) || image.size() < sizeof(ImageHeader))
+    {
+        return false;
+    }
+    ImageHeader header;
+    memcpy(&header, image.data(), sizeof(header));
+    if (header.version != imageVersion || header.byteOrder != imageByteOrder || header.fileSize != image.size())
+    {
+        return false;
+    }
+    if (header.sectionCount > (image.size() - sizeof(ImageHeader)) / sizeof(ImageSection))
+    {
+        return false;
+    }
+
+    sections = reinterpret_cast<const ImageSection *>(image.data() + sizeof(ImageHeader));
+    sectionCount = header.sectionCount;
+    return true;
+}
+
+bool ImageReader::Finished() const
+{
+    return sections != nullptr && nextSection == sectionCount;
+}
+
+bool ImageReader::NextSection(size_t elementSize, size_t alignment, const char *&data, size_t &count)
+{
+    if (sections == nullptr || nextSection == sectionCount)
+    {
+        return false;
+    }
+    const ImageSection &section = sections[nextSection++];
+    if (section.elementSize != elementSize || section.bytes % elementSize != 0 || section.offset % alignment != 0 ||
+        section.offset > image.size() || section.bytes > image.size() - section.offset)
+    {
+        return false;
+    }
+    data = image.data() + section.offset;
+    count = static_cast<size_t>(section.bytes / elementSize);
+    return true;
+}
@@ -0,0 +1,146 @@
+/*
+ * Program Name: Course Planner
+ * Author: Matthew Courts
+ * Description: precompiled binary catalog images
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "FlatArray.h"
+
+/**
+ * Layout of a catalog image. The file starts with an ImageHeader and a table
+ * of sectionCount ImageSections, followed by the sections themselves, each
+ * starting on an 8 byte boundary. A section is one FlatArray written as raw
+ * elements in native byte order, so loading only checks the header and
+ * points each array at its section of the mapped file. The order of the
+ * sections is fixed by the Save functions of the catalog structures, any
+ * change to it or to a record layout needs a new imageVersion.
+ */
+constexpr char imageMagic[8] = {'C', 'P', 'L', 'N', 'I', 'M', 'G', '\0'};
+constexpr uint32_t imageVersion = 1;
+constexpr uint32_t imageByteOrder = 0x01020304;
+
+struct ImageHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder; // imageByteOrder as written, differs on a machine of the other endianness
+    uint32_t sectionCount;
+    uint32_t reserved;
+    uint64_t fileSize;
+};
+
+struct ImageSection
+{
+    uint64_t offset; // from the start of the file
+    uint64_t bytes;
+    uint32_t elementSize;
+    uint32_t reserved;
+};
+
+/**
+ * @param text start of a file
+ * @return status if the file is a catalog image rather than course text
+ */
+bool IsCatalogImage(std::string_view text);
+
+/**
+ * Checks a table of run offsets read from an image
+ *
+ * @param offsets run n covers [offsets[n], offsets[n + 1])
+ * @param count number of elements the runs cover
+ * @return status if the offsets start at 0, never decrease and end at count
+ */
+bool ValidOffsets(const FlatArray<uint32_t> &offsets, size_t count);
+
+/**
+ * @param values indices read from an image
+ * @param limit number of things the indices refer to
+ * @return status if every index is below limit
+ */
+bool AllBelow(const FlatArray<uint32_t> &values, size_t limit);
+
+/**
+ * Collects sections in order and writes them out as one image. The arrays
+ * are only referenced, they must stay unchanged until Write returns.
+ */
+class ImageWriter
+{
+public:
+    template <typename T>
+    void Add(const FlatArray<T> &array)
+    {
+        sections.push_back({array.data(), array.size() * sizeof(T), sizeof(T)});
+    }
+
+    /**
+     * @param path image file to create or truncate
+     * @return status if every byte was written
+     */
+    bool Write(const std::string &path) const;
+
+private:
+    struct Pending
+    {
+        const void *data;
+        size_t bytes;
+        uint32_t elementSize;
+    };
+
+    std::vector<Pending> sections;
+};
+
+/**
+ * Hands out the sections of a mapped image in the order they were written.
+ * The reader checks the header and section table, each structure then checks
+ * its own sections in one linear pass (handles, offsets and indices in
+ * range) so a damaged image is rejected instead of read out of bounds.
+ */
+class ImageReader
+{
+public:
+    /**
+     * @param image whole image, must stay mapped while any array views it
+     * @return status if the header, version and section table are valid
+     */
+    bool Open(std::string_view image);
+
+    /**
+     * Points array at the next section
+     *
+     * @param array receives a view of the section
+     * @return status if there was a next section of this element type
+     */
+    template <typename T>
+    bool Next(FlatArray<T> &array)
+    {
+        const char *data = nullptr;
+        size_t count = 0;
+        if (!NextSection(sizeof(T), alignof(T), data, count))
+        {
+            return false;
+        }
+        array.View(reinterpret_cast<const T *>(data), count);
+        return true;
+    }
+
+    /**
+     * @return status if every section was handed out
+     */
+    bool Finished() const;
+
+private:
+    bool NextSection(size_t elementSize, size_t alignment, const char *&data, size_t &count);
+
+    std::string_view image;
+    const ImageSection *sections = nullptr;
+    uint32_t sectionCount = 0;
+    uint32_t nextSection = 0;
+};
@@ -0,0 +1,173 @@
+/*
+ * Program Name: Course Planner
+ * Author: Matthew Courts
+ * Description: parallel loading of the course data file
+ */
+
+#include "CatalogLoader.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "../../Common/MappedFile.h"
+#include "../../Common/ScanKernel.h"
+
+using namespace std;
+
+// smaller inputs are parsed on one thread
+const size_t minimumChunkBytes = 256 * 1024;
+
+/**
+ * Parses one line into a row without copying
+ *
+ * @param line text of the line without its newline
+ * @return parsed row, empty courseId for a blank line
+ */
+static CourseRow ParseRow(string_view line)
+{
+    CourseRow row;
+    if (!line.empty() && line.back() == '\r')
+    {
+        line.remove_suffix(1);
+    }
+    if (line.empty())
+    {
+        return row;
+    }
+
+    const char *begin = line.data();
+    const char *end = begin + line.size();
+    const char *comma = ScanKernel::Find(begin, end, ',');
+    row.courseId = string_view(begin, static_cast<size_t>(comma - begin));
+    if (comma == end)
+    {
+        return row;
+    }
+
+    const char *nameBegin = comma + 1;
+    comma = ScanKernel::Find(nameBegin, end, ',');
+    row.name = string_view(nameBegin, static_cast<size_t>(comma - nameBegin));
+    if (comma != end)
+    {
+        row.prerequisites = string_view(comma + 1, static_cast<size_t>(end - comma - 1));
+    }
+    return row;
+}
+
+/**
+ * Number of lines in a chunk, counting an unterminated last line
+ */
+static size_t CountLines(string_view chunk)
+{
+    size_t lines = ScanKernel::Count(chunk.data(), chunk.data() + chunk.size(), '\n');
+    return lines + (!chunk.empty() && chunk.back() != '\n' ? 1 : 0);
+}
+
+/**
+ * Parses every line of a chunk into consecutive rows starting at out
+ */
+static void ParseChunk(string_view chunk, CourseRow *out)
+{
+    ForEachLine(chunk, [&out](string_view line)
+                { *out++ = ParseRow(line); });
+}
+
+void ParseCourseRows(string_view text, unsigned threads, vector<CourseRow> &rows)
+{
+    if (threads == 0)
+    {
+        threads = max(thread::hardware_concurrency(), 1u);
+    }
+    threads = static_cast<unsigned>(min<size_t>(threads, max<size_t>(text.size() / minimumChunkBytes, 1)));
+
+    // cut points move forward to the next newline so no line is split
+    vector<string_view> chunks;
+    size_t begin = 0;
+    for (unsigned chunk = 1; chunk <= threads && begin < text.size(); chunk++)
+    {
+        size_t end = text.size();
+        if (chunk < threads)
+        {
+            end = text.find('\n', max(begin, text.size() / threads * chunk));
+            end = end == string_view::npos ? text.size() : end + 1;
+        }
+        chunks.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+
+    // first pass finds where each chunk's rows start
+    vector<size_t> firstRow(chunks.size() + 1, 0);
+    vector<thread> workers;
+    for (size_t chunk = 1; chunk < chunks.size(); chunk++)
+    {
+        workers.emplace_back([&chunks, &firstRow, chunk]()
+                             { firstRow[chunk + 1] = CountLines(chunks[chunk]); });
+    }
+    if (!chunks.empty())
+    {
+        firstRow[1] = CountLines(chunks[0]);
+    }
+    for (thread &worker : workers)
+    {
+        worker.join();
+    }
+    workers.clear();
+    for (size_t chunk = 0; chunk < chunks.size(); chunk++)
+    {
+        firstRow[chunk + 1] += firstRow[chunk];
+    }
+
+    // second pass parses each chunk into its own slice of the row array
+    rows.assign(firstRow.back(), CourseRow());
+    for (size_t chunk = 1; chunk < chunks.size(); chunk++)
+    {
+        workers.emplace_back([&chunks, &firstRow, &rows, chunk]()
+                             { ParseChunk(chunks[chunk], rows.data() + firstRow[chunk]); });
+    }
+    if (!chunks.empty())
+    {
+        ParseChunk(chunks[0], rows.data());
+    }
+    for (thread &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+bool LoadCatalogFile(const string &path, CourseCatalog &catalog, unsigned threads)
+{
+    MappedFile sourceFile;
+    if (!sourceFile.Open(path))
+    {
+        return false;
+    }
+    LoadCatalogText(sourceFile.View(), catalog, threads);
+    return true;
+}
+
+void LoadCatalogText(string_view text, CourseCatalog &catalog, unsigned threads)
+{
+    vector<CourseRow> rows;
+    ParseCourseRows(text, threads, rows);
+
+    // the string pool and id index are shared, so courses are added in file order on this thread
+    vector<string_view> prerequisites;
+    for (const CourseRow &row : rows)
+    {
+        if (row.courseId.empty())
+        {
+            continue;
+        }
+
+        prerequisites.clear();
+        const char *prereq = row.prerequisites.data();
+        const char *end = prereq + row.prerequisites.size();
+        while (prereq < end)
+        {
+            const char *next = ScanKernel::Find(prereq, end, ',');
+            prerequisites.emplace_back(prereq, static_cast<size_t>(next - prereq));
+            prereq = next + 1;
+        }
+        catalog.Add(row.courseId, row.name, prerequisites);
+    }
+}
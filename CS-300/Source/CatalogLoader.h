@@ -0,0 +1,56 @@
+/*
+ * Program Name: Course Planner
+ * Author: Matthew Courts
+ * Description: parallel loading of the course data file
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "CourseCatalog.h"
+
+/**
+ * One parsed line of the course data file, every field is a view into the
+ * mapped file. prerequisites is the raw remainder of the line after the
+ * name, still comma separated. Blank lines produce a row with no courseId.
+ */
+struct CourseRow
+{
+    std::string_view courseId;
+    std::string_view name;
+    std::string_view prerequisites;
+};
+
+/**
+ * Splits text into line aligned chunks and parses them on several threads.
+ * Each thread first counts the lines of its chunk, the counts are summed so
+ * every thread knows where its rows start, and each thread then parses
+ * straight into its part of the preallocated row array.
+ *
+ * @param text whole CSV file
+ * @param threads worker threads, 0 uses one per hardware thread
+ * @param rows receives one row per line in file order
+ */
+void ParseCourseRows(std::string_view text, unsigned threads, std::vector<CourseRow> &rows);
+
+/**
+ * Maps the data file, parses it with ParseCourseRows and adds every course to the catalog
+ *
+ * @param path course data file
+ * @param catalog receives the courses
+ * @param threads worker threads, 0 uses one per hardware thread
+ * @return status if the file could be read
+ */
+bool LoadCatalogFile(const std::string &path, CourseCatalog &catalog, unsigned threads = 0);
+
+/**
+ * Parses CSV text already in memory with ParseCourseRows and adds every course to the catalog
+ *
+ * @param text whole CSV file
+ * @param catalog receives the courses
+ * @param threads worker threads, 0 uses one per hardware thread
+ */
+void LoadCatalogText(std::string_view text, CourseCatalog &catalog, unsigned threads = 0);
@@ -0,0 +1,178 @@
+/*
+ * Program Name: Course Planner
+ * Author: Matthew Courts
+ * Description: immutable catalog snapshots swapped atomically on reload
+ */
+
+#include "CatalogSnapshot.h"
+
+#include <utility>
+
+#include "CatalogImage.h"
+#include "CatalogLoader.h"
+
+using namespace std;
+
+shared_ptr<const CatalogSnapshot> CatalogSnapshot::Load(const string &path, unsigned threads, bool precomputeClosure)
+{
+    MappedFile sourceFile;
+    if (!sourceFile.Open(path))
+    {
+        return nullptr;
+    }
+
+    shared_ptr<CatalogSnapshot> snapshot = make_shared<CatalogSnapshot>();
+    snapshot->sourceIdentity = sourceFile.Identity();
+    snapshot->sourceSize = sourceFile.Size();
+    snapshot->sourceModified = sourceFile.Modified();
+    if (IsCatalogImage(sourceFile.View()))
+    {
+        // sections and records are read by handle for as long as the snapshot lives
+        sourceFile.Advise(FileAccess::Mixed);
+        snapshot->image = move(sourceFile);
+        if (!snapshot->LoadImage())
+        {
+            return nullptr;
+        }
+    }
+    else
+    {
+        LoadCatalogText(sourceFile.View(), snapshot->catalog, threads);
+        if (snapshot->catalog.Empty())
+        {
+            return nullptr;
+        }
+        snapshot->graph.Build(snapshot->catalog);
+        snapshot->search.Build(snapshot->catalog);
+
+        // the views are cached on first use, build them now so readers never write
+        snapshot->catalog.SortedView(CourseOrder::ById);
+        snapshot->catalog.SortedView(CourseOrder::ByName);
+    }
+
+    snapshot->catalog.ValidatePrerequisites(snapshot->missing);
+    if (precomputeClosure)
+    {
+        snapshot->cycle = !snapshot->closureMatrix.Build(snapshot->graph);
+    }
+    return snapshot;
+}
+
+bool CatalogSnapshot::SaveImage(const string &path) const
+{
+    ImageWriter writer;
+    catalog.Save(writer);
+    graph.Save(writer);
+    search.Save(writer);
+    return writer.Write(path);
+}
+
+/**
+ * Points every structure at its sections of the mapped image
+ *
+ * @return status if the image is complete and holds at least one course
+ */
+bool CatalogSnapshot::LoadImage()
+{
+    ImageReader reader;
+    if (!reader.Open(image.View()) || !catalog.Load(reader) || !graph.Load(reader) || !search.Load(reader, catalog))
+    {
+        return false;
+    }
+    return reader.Finished() && !catalog.Empty() && graph.NodeCount() == catalog.Size();
+}
+
+CatalogStore::CatalogStore()
+    : current(make_shared<CatalogSnapshot>()), state(Idle)
+{
+}
+
+CatalogStore::~CatalogStore()
+{
+    Wait();
+}
+
+shared_ptr<const CatalogSnapshot> CatalogStore::Current() const
+{
+    return atomic_load(&current);
+}
+
+void CatalogStore::Publish(shared_ptr<const CatalogSnapshot> snapshot)
+{
+    atomic_store(&current, move(snapshot));
+}
+
+bool CatalogStore::Reload(const string &path, unsigned threads, bool precomputeClosure)
+{
+    if (state.load() == Running)
+    {
+        return false;
+    }
+    if (reloader.joinable())
+    {
+        reloader.join();
+    }
+
+    state.store(Running);
+    reloader = thread([this, path, threads, precomputeClosure]()
+                      {
+                          shared_ptr<const CatalogSnapshot> loaded = CatalogSnapshot::Load(path, threads, precomputeClosure);
+                          if (loaded != nullptr)
+                          {
+                              Publish(loaded);
+                          }
+                          result = move(loaded);
+                          state.store(Finished); });
+    return true;
+}
+
+bool CatalogStore::Reloading() const
+{
+    return state.load() == Running;
+}
+
+void CatalogStore::Wait()
+{
+    if (reloader.joinable())
+    {
+        reloader.join();
+    }
+}
+
+bool CatalogStore::TakeResult(shared_ptr<const CatalogSnapshot> &loaded)
+{
+    if (state.load() != Finished)
+    {
+        return false;
+    }
+    Wait();
+    loaded = move(result);
+    result.reset();
+    state.store(Idle);
+    if (loaded != nullptr)
+    {
+        seenIdentity = loaded->sourceIdentity;
+        seenSize = loaded->sourceSize;
+        seenModified = loaded->sourceModified;
+    }
+    return true;
+}
+
+bool CatalogStore::SourceChanged(const string &path)
+{
+    FileIdentity identity;
+    uint64_t size = 0;
+    int64_t modified = 0;
+    if (!StatFile(path, identity, size, modified))
+    {
+        return false;
+    }
+    if (identity == seenIdentity && size == seenSize && modified == seenModified)
+    {
+        return false;
+    }
+    seenIdentity = identity;
+    seenSize = size;
+    seenModified = modified;
+    return true;
+}
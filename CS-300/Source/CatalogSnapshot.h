@@ -0,0 +1,160 @@
+/*
+ * Program Name: Course Planner
+ * Author: Matthew Courts
+ * Description: immutable catalog snapshots swapped atomically on reload
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../Common/MappedFile.h"
+#include "ClosureMatrix.h"
+#include "CourseCatalog.h"
+#include "CourseSearch.h"
+#include "PrerequisiteGraph.h"
+
+/**
+ * Everything built from one version of the data file. A snapshot is fully
+ * built, sorted views included, before anyone else can see it and is never
+ * changed afterwards, so any number of threads may read it without locks.
+ * The data file is either course text or a catalog image written by
+ * SaveImage, an image is mapped and viewed in place rather than parsed.
+ */
+struct CatalogSnapshot
+{
+    CourseCatalog catalog;
+    PrerequisiteGraph graph;
+    ClosureMatrix closureMatrix; // empty unless requested
+    CourseSearch search;
+    std::vector<std::string> missing; // prerequisite ids not in the catalog
+    bool cycle = false;               // closure requested but the graph has a cycle
+
+    FileIdentity sourceIdentity;
+    uint64_t sourceSize = 0;
+    int64_t sourceModified = 0;
+
+    MappedFile image; // open while the structures above view a catalog image
+
+    CatalogSnapshot() = default;
+    CatalogSnapshot(const CatalogSnapshot &) = delete; // the search index points into the catalog
+    CatalogSnapshot &operator=(const CatalogSnapshot &) = delete;
+
+    /**
+     * Loads the data file and builds every index, or maps them from an image
+     *
+     * @param path course data file or catalog image
+     * @param threads parser threads, 0 uses one per hardware thread
+     * @param precomputeClosure if the closure matrix is wanted
+     * @return new snapshot, nullptr when the file is missing or has no courses
+     */
+    static std::shared_ptr<const CatalogSnapshot> Load(const std::string &path, unsigned threads,
+                                                       bool precomputeClosure);
+
+    /**
+     * Writes the catalog, graph and search indexes as an image that Load
+     * maps without parsing. The closure matrix is left out, it is quadratic
+     * in size and rebuilt on load when requested.
+     *
+     * @param path image file to create or truncate
+     * @return status if the image was written
+     */
+    bool SaveImage(const std::string &path) const;
+
+private:
+    bool LoadImage();
+};
+
+/**
+ * Holds the published snapshot. Readers take a reference with Current and
+ * keep using it for as long as they like, a reload builds the next snapshot
+ * on a background thread and publishes it with one atomic pointer store.
+ * The old snapshot is freed when its last reader lets go. Reload, Wait and
+ * TakeResult belong to one controlling thread, Current may be called from
+ * any thread.
+ */
+class CatalogStore
+{
+public:
+    /**
+     * Starts with an empty snapshot so readers never see nullptr
+     */
+    CatalogStore();
+    ~CatalogStore();
+
+    CatalogStore(const CatalogStore &) = delete;
+    CatalogStore &operator=(const CatalogStore &) = delete;
+
+    /**
+     * @return the published snapshot
+     */
+    std::shared_ptr<const CatalogSnapshot> Current() const;
+
+    /**
+     * Replaces the published snapshot
+     */
+    void Publish(std::shared_ptr<const CatalogSnapshot> snapshot);
+
+    /**
+     * Builds a new snapshot in the background and publishes it when done,
+     * a failed load leaves the published snapshot in place
+     *
+     * @param path course data file
+     * @param threads parser threads, 0 uses one per hardware thread
+     * @param precomputeClosure if the closure matrix is wanted
+     * @return status if a reload was started, false while one is running
+     */
+    bool Reload(const std::string &path, unsigned threads, bool precomputeClosure);
+
+    /**
+     * @return status if a reload is still building
+     */
+    bool Reloading() const;
+
+    /**
+     * Blocks until the running reload, if any, has finished
+     */
+    void Wait();
+
+    /**
+     * Hands back the outcome of a finished reload once
+     *
+     * @param loaded receives the snapshot that was published, nullptr if the load failed
+     * @return status if a finished reload had not been taken yet
+     */
+    bool TakeResult(std::shared_ptr<const CatalogSnapshot> &loaded);
+
+    /**
+     * Compares the data file on disk with the version last loaded or last
+     * seen here, so a file that failed to load is not retried until it
+     * changes again. Only the file's identity, size and write time are read,
+     * the file is mapped by the reload that follows.
+     *
+     * @param path course data file
+     * @return status if the file was replaced or rewritten since
+     */
+    bool SourceChanged(const std::string &path);
+
+private:
+    enum ReloadState
+    {
+        Idle,
+        Running,
+        Finished
+    };
+
+    std::shared_ptr<const CatalogSnapshot> current; // only touched through atomic_load and atomic_store
+    std::shared_ptr<const CatalogSnapshot> result;  // written by the reload thread before Finished
+    std::atomic<int> state;
+    std::thread reloader;
+
+    // version of the data file last loaded or seen by SourceChanged
+    FileIdentity seenIdentity;
+    uint64_t seenSize = 0;
+    int64_t seenModified = 0;
+};
@@ -0,0 +1,102 @@
+/*
+ * Program Name: Course Planner
+ * Author: Matthew Courts
+ * Description: precomputed transitive prerequisite closure
+ */
+
+#include "ClosureMatrix.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+/**
+ * Index of the lowest set bit of a non zero word
+ */
+static unsigned LowestBit64(uint64_t word)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanForward(&index, static_cast<uint32_t>(word)))
+    {
+        return static_cast<unsigned>(index);
+    }
+    _BitScanForward(&index, static_cast<uint32_t>(word >> 32));
+    return static_cast<unsigned>(index) + 32;
+#else
+    return static_cast<unsigned>(__builtin_ctzll(word));
+#endif
+}
+
+bool ClosureMatrix::Build(const PrerequisiteGraph &graph)
+{
+    Clear();
+
+    vector<uint32_t> order;
+    if (!graph.TopologicalOrder(order))
+    {
+        return false;
+    }
+
+    rowCount = graph.NodeCount();
+    wordsPerRow = (rowCount + 63) / 64;
+    bits.assign(rowCount * wordsPerRow, 0);
+
+    // every prerequisite row is final before any course that needs it
+    for (uint32_t course : order)
+    {
+        uint64_t *row = bits.data() + course * wordsPerRow;
+        for (uint32_t prereq : graph.Prerequisites(course))
+        {
+            const uint64_t *prereqRow = bits.data() + prereq * wordsPerRow;
+            for (size_t word = 0; word < wordsPerRow; word++)
+            {
+                row[word] |= prereqRow[word];
+            }
+            row[prereq / 64] |= uint64_t(1) << (prereq % 64);
+        }
+    }
+    return true;
+}
+
+void ClosureMatrix::Clear()
+{
+    rowCount = 0;
+    wordsPerRow = 0;
+    bits.clear();
+    bits.shrink_to_fit();
+}
+
+bool ClosureMatrix::IsBuilt() const
+{
+    return rowCount != 0;
+}
+
+bool ClosureMatrix::Requires(uint32_t course, uint32_t prereq) const
+{
+    return (bits[course * wordsPerRow + prereq / 64] >> (prereq % 64)) & 1;
+}
+
+void ClosureMatrix::Prerequisites(uint32_t course, vector<uint32_t> &prerequisites) const
+{
+    prerequisites.clear();
+    const uint64_t *row = bits.data() + course * wordsPerRow;
+    for (size_t word = 0; word < wordsPerRow; word++)
+    {
+        for (uint64_t remaining = row[word]; remaining != 0; remaining &= remaining - 1)
+        {
+            prerequisites.push_back(static_cast<uint32_t>(word * 64 + LowestBit64(remaining)));
+        }
+    }
+}
+
+size_t ClosureMatrix::MemoryBytes() const
+{
+    return bits.size() * sizeof(uint64_t);
+}
@@ -0,0 +1,67 @@
+/*
+ * Program Name: Course Planner
+ * Author: Matthew Courts
+ * Description: precomputed transitive prerequisite closure
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "PrerequisiteGraph.h"
+
+/**
+ * One packed bitset row per course, bit p of row c is set when course p is
+ * required before course c directly or transitively. Rows are filled in
+ * topological order so each row is the word-parallel OR of its direct
+ * prerequisites' finished rows. Memory is courses^2 / 8 bytes.
+ */
+class ClosureMatrix
+{
+public:
+    /**
+     * Precomputes every row
+     *
+     * @param graph prerequisite graph of the loaded catalog
+     * @return status if the closure was built, false when the graph has a cycle
+     */
+    bool Build(const PrerequisiteGraph &graph);
+
+    /**
+     * Drops the matrix
+     */
+    void Clear();
+
+    /**
+     * @return status if Build has completed
+     */
+    bool IsBuilt() const;
+
+    /**
+     * One bit test
+     *
+     * @param course node id of the course being planned
+     * @param prereq node id of the possible prerequisite
+     * @return status if prereq must be taken before course
+     */
+    bool Requires(uint32_t course, uint32_t prereq) const;
+
+    /**
+     * Scans one row for every prerequisite of a course
+     *
+     * @param course node id of the course
+     * @param prerequisites receives the node ids in ascending order
+     */
+    void Prerequisites(uint32_t course, std::vector<uint32_t> &prerequisites) const;
+
+    /**
+     * @return bytes used by the rows
+     */
+    size_t MemoryBytes() const;
+
+private:
+    size_t rowCount = 0;
+    size_t wordsPerRow = 0;
+    std::vector<uint64_t> bits;
+};
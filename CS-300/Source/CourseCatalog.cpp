@@ -0,0 +1,218 @@
+/*
+ * Program Name: Course Planner
+ * Author: Matthew Courts
+ * Description: course storage with constant time lookup by course id
+ */
+
+#include "CourseCatalog.h"
+
+#include "CatalogImage.h"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+using namespace std;
+
+bool CourseCatalog::Add(string_view courseId, string_view name, const vector<string_view> &prerequisites)
+{
+    uint32_t idHandle = strings.Intern(courseId);
+    if (SlotOf(idHandle) != npos)
+    {
+        return false;
+    }
+
+    Course course;
+    course.courseId = idHandle;
+    course.name = strings.Intern(name);
+    course.prereqOffset = static_cast<uint32_t>(prerequisiteIds.size());
+    course.prereqCount = static_cast<uint32_t>(prerequisites.size());
+    for (string_view prereqId : prerequisites)
+    {
+        prerequisiteIds.push_back(strings.Intern(prereqId));
+    }
+
+    slotByHandle.resize(strings.Size(), noSlot);
+    slotByHandle[idHandle] = static_cast<uint32_t>(courses.size());
+    courses.push_back(course);
+    InvalidateViews();
+    return true;
+}
+
+const Course *CourseCatalog::Find(string_view courseId) const
+{
+    size_t slot = IndexOf(courseId);
+    return slot == npos ? nullptr : &courses[slot];
+}
+
+size_t CourseCatalog::IndexOf(string_view courseId) const
+{
+    uint32_t handle = strings.Find(courseId);
+    return handle == StringPool::npos ? npos : SlotOf(handle);
+}
+
+size_t CourseCatalog::SlotOf(uint32_t handle) const
+{
+    if (handle >= slotByHandle.size() || slotByHandle[handle] == noSlot)
+    {
+        return npos;
+    }
+    return slotByHandle[handle];
+}
+
+string_view CourseCatalog::Text(uint32_t handle) const
+{
+    return strings.View(handle);
+}
+
+string_view CourseCatalog::Id(const Course &course) const
+{
+    return strings.View(course.courseId);
+}
+
+string_view CourseCatalog::Name(const Course &course) const
+{
+    return strings.View(course.name);
+}
+
+CourseCatalog::HandleRange CourseCatalog::Prerequisites(const Course &course) const
+{
+    const uint32_t *first = prerequisiteIds.data() + course.prereqOffset;
+    return HandleRange{first, first + course.prereqCount};
+}
+
+bool CourseCatalog::ValidatePrerequisites(vector<string> &missing) const
+{
+    // every prerequisite of every course is one flat array of handles
+    size_t before = missing.size();
+    for (uint32_t prereq : prerequisiteIds)
+    {
+        if (SlotOf(prereq) == npos)
+        {
+            missing.emplace_back(strings.View(prereq));
+        }
+    }
+    return missing.size() == before;
+}
+
+const Course &CourseCatalog::operator[](size_t slot) const
+{
+    return courses[slot];
+}
+
+size_t CourseCatalog::Size() const
+{
+    return courses.size();
+}
+
+bool CourseCatalog::Empty() const
+{
+    return courses.empty();
+}
+
+void CourseCatalog::Clear()
+{
+    courses.clear();
+    prerequisiteIds.clear();
+    strings.Clear();
+    slotByHandle.clear();
+    InvalidateViews();
+}
+
+size_t CourseCatalog::MemoryBytes() const
+{
+    return courses.capacity() * sizeof(Course) + (prerequisiteIds.capacity() + slotByHandle.capacity()) * sizeof(uint32_t) +
+           strings.MemoryBytes();
+}
+
+const Course *CourseCatalog::begin() const
+{
+    return courses.begin();
+}
+
+const Course *CourseCatalog::end() const
+{
+    return courses.end();
+}
+
+const FlatArray<uint32_t> &CourseCatalog::SortedView(CourseOrder order) const
+{
+    FlatArray<uint32_t> &view = order == CourseOrder::ById ? byId : byName;
+    if (view.size() == courses.size())
+    {
+        return view;
+    }
+
+    view.resize(courses.size());
+    iota(view.begin(), view.end(), 0);
+    if (order == CourseOrder::ById)
+    {
+        sort(view.begin(), view.end(), [this](uint32_t a, uint32_t b)
+             { return Id(courses[a]) < Id(courses[b]); });
+    }
+    else
+    {
+        // equal names keep load order
+        sort(view.begin(), view.end(), [this](uint32_t a, uint32_t b)
+             {
+                 int compared = Name(courses[a]).compare(Name(courses[b]));
+                 return compared != 0 ? compared < 0 : a < b; });
+    }
+    return view;
+}
+
+void CourseCatalog::Save(ImageWriter &image) const
+{
+    image.Add(courses);
+    image.Add(prerequisiteIds);
+    strings.Save(image);
+    image.Add(slotByHandle);
+    image.Add(SortedView(CourseOrder::ById));
+    image.Add(SortedView(CourseOrder::ByName));
+}
+
+bool CourseCatalog::Load(ImageReader &image)
+{
+    if (!image.Next(courses) || !image.Next(prerequisiteIds) || !strings.Load(image) || !image.Next(slotByHandle) ||
+        !image.Next(byId) || !image.Next(byName))
+    {
+        Clear();
+        return false;
+    }
+    if (slotByHandle.size() != strings.Size() || byId.size() != courses.size() || byName.size() != courses.size() ||
+        !AllBelow(prerequisiteIds, strings.Size()) || !AllBelow(byId, courses.size()) ||
+        !AllBelow(byName, courses.size()))
+    {
+        Clear();
+        return false;
+    }
+
+    // every record names strings in the pool and a run of the prerequisite array,
+    // and the id index points each course id back at its own record
+    for (size_t slot = 0; slot < courses.size(); slot++)
+    {
+        const Course &course = courses[slot];
+        if (course.courseId >= strings.Size() || course.name >= strings.Size() ||
+            static_cast<uint64_t>(course.prereqOffset) + course.prereqCount > prerequisiteIds.size() ||
+            slotByHandle[course.courseId] != slot)
+        {
+            Clear();
+            return false;
+        }
+    }
+    for (uint32_t slot : slotByHandle)
+    {
+        if (slot != noSlot && slot >= courses.size())
+        {
+            Clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+void CourseCatalog::InvalidateViews()
+{
+    byId.clear();
+    byName.clear();
+}
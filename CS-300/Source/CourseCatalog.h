@@ -0,0 +1,168 @@
+/*
+ * Program Name: Course Planner
+ * Author: Matthew Courts
+ * Description: course storage with constant time lookup by course id
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "FlatArray.h"
+#include "StringPool.h"
+
+/**
+ * Fixed size course record. Id and name are handles into the catalog's
+ * string pool and the prerequisite handles are a run of the catalog's
+ * shared prerequisite array, resolve them through CourseCatalog.
+ */
+struct Course
+{
+    uint32_t courseId;
+    uint32_t name;
+    uint32_t prereqOffset;
+    uint32_t prereqCount;
+};
+
+/**
+ * Orders available from CourseCatalog::SortedView
+ */
+enum class CourseOrder
+{
+    ById,
+    ByName
+};
+
+/**
+ * Courses stored contiguously in load order. Ids, names and prerequisite ids
+ * are interned once in a string pool, and a slot per pool handle maps a
+ * course id handle to its course, so lookups hash the id once and hand back
+ * a reference to the stored record.
+ */
+class CourseCatalog
+{
+public:
+    static const size_t npos = static_cast<size_t>(-1);
+
+    /**
+     * Contiguous run of string handles
+     */
+    struct HandleRange
+    {
+        const uint32_t *first;
+        const uint32_t *last;
+
+        const uint32_t *begin() const { return first; }
+        const uint32_t *end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+    };
+
+    /**
+     * Adds a course unless its id is already in the catalog
+     *
+     * @param courseId id of the course
+     * @param name title of the course
+     * @param prerequisites ids of the direct prerequisites
+     * @return status if the course was added
+     */
+    bool Add(std::string_view courseId, std::string_view name, const std::vector<std::string_view> &prerequisites);
+
+    /**
+     * Finds a course by id
+     *
+     * @param courseId id of the course being searched for
+     * @return pointer to the stored course, nullptr if not found
+     */
+    const Course *Find(std::string_view courseId) const;
+
+    /**
+     * Slot of a course by id
+     *
+     * @param courseId id of the course being searched for
+     * @return slot of the course, npos if not found
+     */
+    size_t IndexOf(std::string_view courseId) const;
+
+    /**
+     * Slot of a course by interned id, no hashing
+     *
+     * @param handle string handle of a course id
+     * @return slot of the course, npos if no course has that id
+     */
+    size_t SlotOf(uint32_t handle) const;
+
+    /**
+     * Text of an interned string, valid until the catalog changes
+     */
+    std::string_view Text(uint32_t handle) const;
+    std::string_view Id(const Course &course) const;
+    std::string_view Name(const Course &course) const;
+
+    /**
+     * Id handles of the direct prerequisites of a course
+     */
+    HandleRange Prerequisites(const Course &course) const;
+
+    /**
+     * Checks every prerequisite against the id index in a single pass
+     *
+     * @param missing receives each prerequisite id that is not in the catalog
+     * @return status if all prerequisites exist
+     */
+    bool ValidatePrerequisites(std::vector<std::string> &missing) const;
+
+    const Course &operator[](size_t slot) const;
+    size_t Size() const;
+    bool Empty() const;
+    void Clear();
+
+    /**
+     * @return bytes used by records, prerequisite handles, index and strings
+     */
+    size_t MemoryBytes() const;
+
+    const Course *begin() const;
+    const Course *end() const;
+
+    /**
+     * Slots of every course in the requested order. The permutation is sorted
+     * once (introsort over slot numbers, courses never move) and cached until
+     * the catalog changes, so repeated listings cost nothing.
+     *
+     * @param order sort key
+     * @return slots in sorted order, valid until the catalog changes
+     */
+    const FlatArray<uint32_t> &SortedView(CourseOrder order) const;
+
+    /**
+     * Adds the records, prerequisite handles, string pool, id index and both
+     * sorted views to an image, building the views first if needed
+     */
+    void Save(ImageWriter &image) const;
+
+    /**
+     * Views a catalog saved in an image. Nothing is parsed, hashed or sorted
+     * and nothing is copied until the catalog is changed.
+     *
+     * @param image reader positioned at the catalog's sections
+     * @return status if the sections were present and consistent
+     */
+    bool Load(ImageReader &image);
+
+private:
+    static constexpr uint32_t noSlot = static_cast<uint32_t>(-1);
+
+    void InvalidateViews();
+
+    FlatArray<Course> courses;
+    FlatArray<uint32_t> prerequisiteIds;
+    StringPool strings;
+    FlatArray<uint32_t> slotByHandle; // course slot per string handle, noSlot for other strings
+
+    // cached permutations, empty means not built yet
+    mutable FlatArray<uint32_t> byId;
+    mutable FlatArray<uint32_t> byName;
+};
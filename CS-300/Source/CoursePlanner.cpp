@@ -7,288 +7,589 @@
 
 #include <algorithm>
 #include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <sstream>
-#include <fstream>
+#include <utility>
 
-using namespace std;
-
-/******************* Globals *******************/
-
-struct Course
-{
-    string name;
-    string courseId;
-    vector<string> prerequisites;
-};
+#include "../../Common/BufferedWriter.h"
+#include "../../Common/MappedFile.h"
+#include "CatalogSnapshot.h"
+#include "ClosureMatrix.h"
+#include "CourseCatalog.h"
+#include "CourseSearch.h"
+#include "PrerequisiteGraph.h"
+#include "SemesterScheduler.h"
 
-vector<Course> courseList;
+using namespace std;
 
 /******************* Main Program - Supporting Methods *******************/
 
-string courseDataFile = "classes.csv";
-
 /**
- * Split a string by delimiter returning list of the contents
+ * Reports the outcome of loading the course data, missing prerequisites
+ * first, then the load status and any prerequisite cycle
  *
- * @param str string to be split
- * @param del delimiter used for splitting string
- * @return vector list of line separated
+ * @param out output sink
+ * @param loaded snapshot that was loaded, nullptr if the load failed
+ * @return status if the data loaded and all prerequisite courses exist
  *
  */
-vector<string> splitString(string str, char del)
+bool reportLoad(BufferedWriter &out, const shared_ptr<const CatalogSnapshot> &loaded)
 {
-    vector<string> contents;
-    stringstream ss(str);
-    string token;
+    bool status = loaded != nullptr && loaded->missing.empty();
+    if (loaded != nullptr)
+    {
+        for (const string &prereqID : loaded->missing)
+        {
+            out.Write(prereqID);
+            out.Write(" Prequisite course missing\n");
+        }
+    }
 
-    while (getline(ss, token, del))
+    if (status)
+    {
+        out.Write("Course data loaded successfuly.\n");
+    }
+    else
+    {
+        out.Write("There was a problem loaded the course data, validate data file and prerequisite course2 are included\n");
+    }
+    if (loaded != nullptr && loaded->cycle)
     {
-        contents.push_back(token);
+        out.Write("Prerequisite cycle found, closure not precomputed\n");
     }
-    return contents;
+    out.Flush();
+    return status;
 }
 
 /**
- * Load data file
+ * prints all prerequisite courses
  *
- * @param contents pointer to source datalist for contents to be loaded
- * @return status if file loading was successful or not
+ * @param out output sink
+ * @param courseList catalog holding the course
+ * @param course the course data
  *
  */
-bool ParseFileContents(vector<Course> &contents)
+void printPrerequisite(BufferedWriter &out, const CourseCatalog &courseList, const Course &course)
 {
-    bool result = false;
-    fstream sourceFile;
-    sourceFile.open(courseDataFile, fstream::in);
-    string lineBuffer;
-
-    if (sourceFile.is_open())
+    out.Write("Prerequisites: ");
+    if (course.prereqCount != 0)
     {
-        while (getline(sourceFile, lineBuffer))
-        {
-            if (lineBuffer != "")
-            {
-                vector<string> line = splitString(lineBuffer, ',');
-                Course course;
-
-                course.courseId = line.front();
-                line.erase(line.begin());
-                course.name = line.front();
 
-                if (line.size() > 0)
-                {
-                    line.erase(line.begin());
-                    course.prerequisites = line;
-                }
-                contents.push_back(course);
-            }
+        for (uint32_t prepreq : courseList.Prerequisites(course))
+        {
+            out.Write(courseList.Text(prepreq));
+            out.Write(", ");
         }
-        result = true;
     }
     else
     {
-        return result;
+        out.Write("None");
     }
-
-    sourceFile.close();
-    return result;
+    out.Write('\n');
 }
 
 /**
- * Searches a vector list for a course by id
+ * Prints course information
  *
- * @param contents source list to be searched
- * @param ID id of the course being searched for
- * @return course if found
+ * @param out output sink
+ * @param courseList catalog holding the course
+ * @param course the course data
+ * @param prereq if the prerequisite list is to be printed
  *
  */
-Course SearchCourseListByID(vector<Course> &contents, string ID)
-{
-    auto it = find_if(contents.begin(), contents.end(), [ID](Course course)
-                      { return course.courseId == ID; });
 
-    if (it != contents.end())
+void printCourse(BufferedWriter &out, const CourseCatalog &courseList, const Course &course, bool prereq = false)
+{
+    out.Write(courseList.Id(course));
+    out.Write(", ");
+    out.Write(courseList.Name(course));
+    out.Write('\n');
+    if (prereq)
     {
-        return *it;
+        printPrerequisite(out, courseList, course);
     }
-    else
+}
+
+/**
+ * wrapper procedure for printing all courses
+ *
+ * @param out output sink
+ * @param courseList list of all courses
+ * @param order sort key for the listing
+ *
+ */
+void printCourseList(BufferedWriter &out, const CourseCatalog &courseList, CourseOrder order)
+{
+    out.Write("Course List:\n");
+    for (uint32_t slot : courseList.SortedView(order))
     {
-        return Course();
+        printCourse(out, courseList, courseList[slot]);
     }
 }
 
 /**
- * pupulates courselist and checks that all prerequisite courses exist
+ * Prints every course in an order that satisfies all prerequisites,
+ * or the courses of a prerequisite cycle when no such order exists
  *
- * @param contents pointer to source datalist for contents to be loaded
- * @return status if all courses exist
+ * @param out output sink
+ * @param courseList list of all courses
+ * @param graph prerequisite graph built from courseList
  *
  */
-bool loadcourselist(vector<Course> &contents)
+void printStudyPlan(BufferedWriter &out, const CourseCatalog &courseList, const PrerequisiteGraph &graph)
 {
-    bool status = true;
-    ParseFileContents(contents);
-
-    // validate prereqs are included.
-    if (contents.size() > 0)
+    vector<uint32_t> order;
+    if (!graph.TopologicalOrder(order))
     {
-        for (Course course : contents)
+        vector<uint32_t> cycle;
+        graph.FindCycle(cycle);
+        out.Write("No study plan exists, these courses require each other: ");
+        for (uint32_t node : cycle)
         {
-            for (string prereqID : course.prerequisites)
-            {
-                Course prereq = SearchCourseListByID(contents, prereqID);
-                if (prereq.name == "")
-                {
-                    cout << prereqID << " Prequisite course missing" << endl;
-                    status = false;
-                }
-            }
+            out.Write(courseList.Id(courseList[node]));
+            out.Write(' ');
         }
+        out.Write('\n');
+        return;
     }
-    else
+
+    out.Write("Study Plan:\n");
+    for (size_t step = 0; step < order.size(); step++)
     {
-        status = false;
+        out.Write("  ");
+        out.WriteNumber(step + 1);
+        out.Write(". ");
+        printCourse(out, courseList, courseList[order[step]]);
     }
-
-    return status;
 }
 
 /**
- * prints all prerequisite courses
+ * Prints every course required before a course, directly or transitively
+ * Uses the precomputed closure when it was built, otherwise walks the graph,
+ * either way the courses are printed in catalog order
  *
+ * @param out output sink
+ * @param courseList list of all courses
+ * @param graph prerequisite graph built from courseList
+ * @param closureMatrix precomputed closure, may be empty
  * @param course the course data
  *
  */
-void printPrerequisite(Course course)
+void printAllPrerequisites(BufferedWriter &out, const CourseCatalog &courseList, const PrerequisiteGraph &graph,
+                           const ClosureMatrix &closureMatrix, const Course &course)
 {
-    cout << "Prerequisites: ";
-    if (course.prerequisites.size() != 0)
+    uint32_t node = static_cast<uint32_t>(courseList.SlotOf(course.courseId));
+    vector<uint32_t> closure;
+    if (closureMatrix.IsBuilt())
     {
-
-        for (string prepreq : course.prerequisites)
-        {
-            cout << prepreq << ", ";
-        }
+        closureMatrix.Prerequisites(node, closure);
     }
     else
     {
-        cout << "None";
+        graph.PrerequisiteClosure(node, closure);
+        // the walk yields post-order, the matrix rows ascending slots
+        sort(closure.begin(), closure.end());
+    }
+
+    out.Write("All prerequisites of ");
+    out.Write(courseList.Id(course));
+    out.Write(": ");
+    if (closure.empty())
+    {
+        out.Write("None");
+    }
+    for (uint32_t prereq : closure)
+    {
+        out.Write(courseList.Id(courseList[prereq]));
+        out.Write(' ');
     }
-    cout << endl;
+    out.Write('\n');
 }
 
 /**
- * Prints course information
+ * Checks if one course must be taken before another
  *
- * @param course the course data
- * @param prereq if the prerequisite list is to be printed
+ * @param courseList list of all courses
+ * @param graph prerequisite graph built from courseList
+ * @param closureMatrix precomputed closure, may be empty
+ * @param course the course being planned
+ * @param prereq the possible prerequisite
+ * @return status if prereq is required before course
  *
  */
-
-void printCourse(Course course, bool prereq = false)
+bool requiresCourse(const CourseCatalog &courseList, const PrerequisiteGraph &graph,
+                    const ClosureMatrix &closureMatrix, const Course &course, const Course &prereq)
 {
-    cout << course.courseId << ", " << course.name << endl;
-    if (prereq)
+    uint32_t node = static_cast<uint32_t>(courseList.SlotOf(course.courseId));
+    uint32_t prereqNode = static_cast<uint32_t>(courseList.SlotOf(prereq.courseId));
+    if (closureMatrix.IsBuilt())
     {
-        printPrerequisite(course);
+        return closureMatrix.Requires(node, prereqNode);
     }
+
+    vector<uint32_t> closure;
+    graph.PrerequisiteClosure(node, closure);
+    return find(closure.begin(), closure.end(), prereqNode) != closure.end();
 }
 
 /**
- * wrapper procedure for printing all courses
+ * Prints the courses matching a search, as a course id prefix when any id
+ * starts with the text and otherwise as a fragment of the course name
  *
+ * @param out output sink
  * @param courseList list of all courses
+ * @param search indexes built from courseList
+ * @param text id prefix or name fragment
+ * @param limit most courses printed
  *
  */
-void printCourseList(vector<Course> &courseList)
+void printSearch(BufferedWriter &out, const CourseCatalog &courseList, const CourseSearch &search,
+                 string_view text, size_t limit)
 {
-    cout << "Course List:" << endl;
-    for (Course course : courseList)
+    vector<SearchMatch> matches;
+    size_t found = search.ByIdPrefix(text, limit, matches);
+    if (found == 0)
+    {
+        found = search.ByName(text, limit, matches);
+    }
+
+    out.Write("Search results for ");
+    out.Write(text);
+    out.Write(":\n");
+    for (const SearchMatch &match : matches)
     {
-        printCourse(course);
+        printCourse(out, courseList, courseList[match.slot]);
+    }
+    if (found == 0)
+    {
+        out.Write("None\n");
+    }
+    else if (found > matches.size())
+    {
+        out.WriteNumber(found - matches.size());
+        out.Write(" more not shown\n");
     }
 }
 
 /**
- * Partition the vector of course into two parts, low and high
+ * Writes the not found answer for a course id
+ */
+void printNotFound(BufferedWriter &out, string_view courseId)
+{
+    out.Write("Course not found: ");
+    out.Write(courseId);
+    out.Write('\n');
+}
+
+/**
+ * Prints a semester schedule, one line per term
  *
- * @param course Address of the vector<Course> instance to be partitioned
- * @param begin Beginning index to partition
- * @param end Ending index to partition
- * @return high value
+ * @param out output sink
+ * @param courseList list of all courses
+ * @param label student or request the schedule belongs to
+ * @param schedule planned terms
  *
  */
-int partition(vector<Course> &course, int begin, int end)
+void printSchedule(BufferedWriter &out, const CourseCatalog &courseList, string_view label, const Schedule &schedule)
 {
-    int low = begin;
-    int high = end;
-    int pivot = low + (high - low) / 2;
-    string pivotVal = course[pivot].name;
-    bool done = false;
+    out.Write(label);
+    if (!schedule.complete)
+    {
+        out.Write(": No schedule exists, these courses require each other\n");
+        return;
+    }
+    out.Write(": ");
+    out.WriteNumber(schedule.TermCount());
+    out.Write(" terms\n");
 
-    while (!done)
+    uint32_t termStart = 0;
+    for (size_t term = 0; term < schedule.TermCount(); term++)
     {
-        // shift low iterator
-        while (course[low].name < pivotVal)
+        out.Write("  Term ");
+        out.WriteNumber(term + 1);
+        out.Write(':');
+        for (uint32_t course = termStart; course < schedule.termEnds[term]; course++)
         {
-            low += 1;
+            out.Write(' ');
+            out.Write(courseList.Id(courseList[schedule.courses[course]]));
         }
+        out.Write('\n');
+        termStart = schedule.termEnds[term];
+    }
+}
 
-        // shift high iterator
-        while (pivotVal < course[high].name)
+/**
+ * Plans every student of a student file and prints the schedules in file
+ * order. Each line is a student id followed by the courses they want,
+ * comma separated. Students are planned in parallel against the shared
+ * read-only catalog and graph.
+ *
+ * @param out output sink
+ * @param studentPath student file
+ * @param courseList list of all courses
+ * @param graph prerequisite graph built from courseList
+ * @param creditCap most credits per term
+ * @param threads planning threads, 0 uses one per hardware thread
+ * @return status if the student file could be read
+ *
+ */
+bool runSchedules(BufferedWriter &out, const string &studentPath, const CourseCatalog &courseList,
+                  const PrerequisiteGraph &graph, unsigned creditCap, unsigned threads)
+{
+    MappedFile students;
+    if (!students.Open(studentPath))
+    {
+        return false;
+    }
+
+    vector<string_view> studentIds;
+    vector<vector<uint32_t>> targets;
+    vector<string_view> unknown; // first unknown course per student, empty when all were found
+    ForEachLine(students.View(), [&](string_view line)
+                {
+                    if (line.empty())
+                    {
+                        return;
+                    }
+                    size_t comma = line.find(',');
+                    studentIds.push_back(line.substr(0, comma));
+                    targets.emplace_back();
+                    unknown.emplace_back();
+                    while (comma != string_view::npos)
+                    {
+                        size_t next = line.find(',', comma + 1);
+                        string_view courseId = line.substr(comma + 1, next == string_view::npos ? string_view::npos : next - comma - 1);
+                        size_t slot = courseList.IndexOf(courseId);
+                        if (slot != CourseCatalog::npos)
+                        {
+                            targets.back().push_back(static_cast<uint32_t>(slot));
+                        }
+                        else if (unknown.back().empty() && !courseId.empty())
+                        {
+                            unknown.back() = courseId;
+                        }
+                        comma = next;
+                    } });
+
+    vector<Schedule> schedules;
+    SemesterScheduler(graph).PlanAll(targets, creditCap, threads, schedules);
+    for (size_t student = 0; student < schedules.size(); student++)
+    {
+        if (!unknown[student].empty())
         {
-            high -= 1;
+            out.Write(studentIds[student]);
+            out.Write(": ");
+            printNotFound(out, unknown[student]);
+            continue;
         }
+        printSchedule(out, courseList, studentIds[student], schedules[student]);
+    }
+    return true;
+}
+
+/******************* Batch mode *******************/
 
-        // if iterators meet exit or swap values
-        if (low >= high)
+/**
+ * Settings shared by every batch query
+ */
+struct BatchOptions
+{
+    size_t searchLimit = 10;  // most courses printed for a search
+    unsigned creditCap = 15;  // most credits per term for a schedule
+};
+
+/**
+ * Splits the next whitespace separated word off the front of a query
+ *
+ * @param query remaining text, advanced past the word
+ * @return the word, empty when the query is used up
+ */
+string_view nextWord(string_view &query)
+{
+    size_t begin = query.find_first_not_of(" \t");
+    if (begin == string_view::npos)
+    {
+        query = string_view();
+        return query;
+    }
+    size_t end = query.find_first_of(" \t", begin);
+    end = end == string_view::npos ? query.size() : end;
+    string_view word = query.substr(begin, end - begin);
+    query.remove_prefix(end);
+    return word;
+}
+
+/**
+ * Answers one batch query, one of
+ *   lookup ID          course and its direct prerequisites
+ *   list [name|id]     every course, by name unless id is given
+ *   prereqs ID         every prerequisite, direct or transitive
+ *   requires ID OTHER  if OTHER must be taken before ID
+ *   plan               study plan for the whole catalog
+ *   search TEXT        courses by id prefix or name fragment
+ *   schedule ID...     fewest terms that cover the courses and their prerequisites
+ * Blank lines and lines starting with # are skipped.
+ *
+ * @param out output sink
+ * @param courseList list of all courses
+ * @param graph prerequisite graph built from courseList
+ * @param closureMatrix precomputed closure, may be empty
+ * @param search indexes built from courseList
+ * @param options search limit and credit cap
+ * @param query text of the query line
+ *
+ */
+void answerQuery(BufferedWriter &out, const CourseCatalog &courseList, const PrerequisiteGraph &graph,
+                 const ClosureMatrix &closureMatrix, const CourseSearch &search, const BatchOptions &options,
+                 string_view query)
+{
+    string_view remaining = query;
+    string_view command = nextWord(remaining);
+    if (command.empty() || command.front() == '#')
+    {
+        return;
+    }
+
+    string_view arguments = remaining;
+    string_view courseId = nextWord(remaining);
+    const Course *course = courseList.Find(courseId);
+    if (command == "lookup" || command == "prereqs" || command == "requires")
+    {
+        if (course == nullptr)
+        {
+            printNotFound(out, courseId);
+        }
+        else if (command == "lookup")
         {
-            done = true;
+            printCourse(out, courseList, *course, true);
+        }
+        else if (command == "prereqs")
+        {
+            printAllPrerequisites(out, courseList, graph, closureMatrix, *course);
         }
         else
         {
-            swap(course[low], course[high]);
-            low += 1;
-            high -= 1;
+            string_view prereqId = nextWord(remaining);
+            const Course *prereq = courseList.Find(prereqId);
+            if (prereq == nullptr)
+            {
+                printNotFound(out, prereqId);
+                return;
+            }
+            out.Write(courseId);
+            out.Write(requiresCourse(courseList, graph, closureMatrix, *course, *prereq) ? " requires " : " does not require ");
+            out.Write(prereqId);
+            out.Write('\n');
+        }
+    }
+    else if (command == "list")
+    {
+        printCourseList(out, courseList, courseId == "id" ? CourseOrder::ById : CourseOrder::ByName);
+    }
+    else if (command == "plan")
+    {
+        printStudyPlan(out, courseList, graph);
+    }
+    else if (command == "search")
+    {
+        // the search text is the rest of the line, names contain spaces
+        size_t textStart = arguments.find_first_not_of(" \t");
+        printSearch(out, courseList, search, textStart == string_view::npos ? string_view() : arguments.substr(textStart),
+                    options.searchLimit);
+    }
+    else if (command == "schedule")
+    {
+        vector<uint32_t> targets;
+        for (; !courseId.empty(); courseId = nextWord(remaining))
+        {
+            size_t slot = courseList.IndexOf(courseId);
+            if (slot == CourseCatalog::npos)
+            {
+                printNotFound(out, courseId);
+                return;
+            }
+            targets.push_back(static_cast<uint32_t>(slot));
         }
+        Schedule schedule;
+        SemesterScheduler(graph).Plan(targets, options.creditCap, schedule);
+        printSchedule(out, courseList, "Schedule", schedule);
+    }
+    else
+    {
+        out.Write("Unknown query: ");
+        out.Write(query);
+        out.Write('\n');
     }
-
-    return high;
 }
 
 /**
- * Perform a quick sort on course id
- * Average performance: O(n log(n))
- * Worst case performance O(n^2))
+ * Answers every query of a query file, or of stdin when the path is -
+ * Stdin is read in blocks and answered a line at a time so a pipe is never
+ * held in memory as a whole.
  *
- * @param course address of the vector<Course> instance to be sorted
- * @param begin the beginning index to sort on
- * @param end the ending index to sort on
+ * @param out output sink
+ * @param queryPath query file or -
+ * @param courseList list of all courses
+ * @param graph prerequisite graph built from courseList
+ * @param closureMatrix precomputed closure, may be empty
+ * @param search indexes built from courseList
+ * @param options search limit and credit cap
+ * @return status if the queries could be read
  *
  */
-void quickSort(vector<Course> &course, int begin, int end)
+bool runBatch(BufferedWriter &out, const string &queryPath, const CourseCatalog &courseList,
+              const PrerequisiteGraph &graph, const ClosureMatrix &closureMatrix, const CourseSearch &search,
+              const BatchOptions &options)
 {
-    // base statement
-    if (begin >= end)
+    auto answer = [&](string_view query)
+    { answerQuery(out, courseList, graph, closureMatrix, search, options, query); };
+
+    if (queryPath != "-")
     {
-        return;
+        MappedFile queries;
+        if (!queries.Open(queryPath))
+        {
+            return false;
+        }
+        ForEachLine(queries.View(), answer);
+        return true;
     }
 
-    // set low bounds for splitting sort
-    int low = partition(course, begin, end);
-    // recursive lower bounds
-    quickSort(course, begin, low);
-    // recuirsive upper bounds
-    quickSort(course, low + 1, end);
+    vector<char> block(1 << 16);
+    string pending;
+    size_t received;
+    while ((received = fread(block.data(), 1, block.size(), stdin)) > 0)
+    {
+        pending.append(block.data(), received);
+        size_t complete = pending.rfind('\n');
+        if (complete != string::npos)
+        {
+            ForEachLine(string_view(pending).substr(0, complete + 1), answer);
+            pending.erase(0, complete + 1);
+        }
+    }
+    ForEachLine(pending, answer);
+    return true;
 }
 
 /******************* Main program *******************/
 
 /**
  * Program entry point and menu interaction
+ * --closure precomputes the transitive prerequisite matrix on load
+ * --threads N sets the number of threads parsing the data file and planning schedules
+ * --data FILE reads the courses from FILE instead of classes.csv, FILE may be a catalog image
+ * --batch FILE answers the queries in FILE (- for stdin) and exits, see answerQuery
+ * --limit N prints at most N courses per search, 10 by default
+ * --schedule FILE plans every student in FILE and exits, see runSchedules
+ * --credits N caps each term at N credits for schedules, 15 by default, at least 3
+ * --compile CSV IMAGE writes the courses in CSV as a catalog image and exits
  *
  * @param argc count of arguments passed by cli
  * @param argv array pointer of all passed arguments
@@ -297,51 +598,273 @@ void quickSort(vector<Course> &course, int begin, int end)
 int main(int argc, char *argv[])
 {
     int choice = 0;
-    vector<Course> courseList;
+    CatalogStore store;
+    shared_ptr<const CatalogSnapshot> snapshot;
+    shared_ptr<const CatalogSnapshot> reloaded;
+    BatchOptions options;
+    string studentFile;
+    bool precomputeClosure = false;
+    unsigned loadThreads = 0;
+    string dataFile = "classes.csv";
+    string queryFile;
+    string imageFile;
+    BufferedWriter out;
     string searchCourseID;
-    Course searchResult;
+    string prereqCourseID;
+    string searchText;
+    const Course *searchResult = nullptr;
+    const Course *prereqResult = nullptr;
+
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if (strcmp(argv[arg], "--closure") == 0)
+        {
+            precomputeClosure = true;
+        }
+        else if (strcmp(argv[arg], "--threads") == 0 && arg + 1 < argc)
+        {
+            loadThreads = static_cast<unsigned>(strtoul(argv[++arg], nullptr, 10));
+        }
+        else if (strcmp(argv[arg], "--data") == 0 && arg + 1 < argc)
+        {
+            dataFile = argv[++arg];
+        }
+        else if (strcmp(argv[arg], "--batch") == 0 && arg + 1 < argc)
+        {
+            queryFile = argv[++arg];
+        }
+        else if (strcmp(argv[arg], "--limit") == 0 && arg + 1 < argc)
+        {
+            options.searchLimit = strtoul(argv[++arg], nullptr, 10);
+        }
+        else if (strcmp(argv[arg], "--schedule") == 0 && arg + 1 < argc)
+        {
+            studentFile = argv[++arg];
+        }
+        else if (strcmp(argv[arg], "--credits") == 0 && arg + 1 < argc)
+        {
+            // a cap below one course's credits cannot be met, reject it rather than plan over it
+            const char *value = argv[++arg];
+            unsigned long credits = strtoul(value, nullptr, 10);
+            if (credits < SemesterScheduler::creditsPerCourse || credits > UINT_MAX)
+            {
+                BufferedWriter errors(stderr);
+                errors.Write("Invalid --credits ");
+                errors.Write(value);
+                errors.Write(", a term must allow at least ");
+                errors.WriteNumber(SemesterScheduler::creditsPerCourse);
+                errors.Write(" credits\n");
+                return 1;
+            }
+            options.creditCap = static_cast<unsigned>(credits);
+        }
+        else if (strcmp(argv[arg], "--compile") == 0 && arg + 2 < argc)
+        {
+            dataFile = argv[++arg];
+            imageFile = argv[++arg];
+        }
+    }
+
+    // the image is mapped by --data later, so cold starts skip parsing and index builds
+    if (!imageFile.empty())
+    {
+        BufferedWriter errors(stderr);
+        snapshot = CatalogSnapshot::Load(dataFile, loadThreads, false);
+        if (snapshot == nullptr)
+        {
+            errors.Write("Could not load course data from ");
+            errors.Write(dataFile);
+            errors.Write('\n');
+            return 1;
+        }
+        for (const string &prereqID : snapshot->missing)
+        {
+            errors.Write(prereqID);
+            errors.Write(" Prequisite course missing\n");
+        }
+        errors.Flush();
+        if (!snapshot->SaveImage(imageFile))
+        {
+            errors.Write("Could not write catalog image ");
+            errors.Write(imageFile);
+            errors.Write('\n');
+            return 1;
+        }
+        out.WriteNumber(snapshot->catalog.Size());
+        out.Write(" courses compiled to ");
+        out.Write(imageFile);
+        out.Write('\n');
+        return 0;
+    }
+
+    // batch answers go to stdout alone, load problems go to stderr
+    if (!queryFile.empty() || !studentFile.empty())
+    {
+        BufferedWriter errors(stderr);
+        snapshot = CatalogSnapshot::Load(dataFile, loadThreads, precomputeClosure);
+        if (snapshot == nullptr)
+        {
+            errors.Write("Could not load course data from ");
+            errors.Write(dataFile);
+            errors.Write('\n');
+            return 1;
+        }
+        for (const string &prereqID : snapshot->missing)
+        {
+            errors.Write(prereqID);
+            errors.Write(" Prequisite course missing\n");
+        }
+        if (snapshot->cycle)
+        {
+            errors.Write("Prerequisite cycle found, closure not precomputed\n");
+        }
+        errors.Flush();
+
+        if (!queryFile.empty() &&
+            !runBatch(out, queryFile, snapshot->catalog, snapshot->graph, snapshot->closureMatrix, snapshot->search, options))
+        {
+            errors.Write("Could not read queries from ");
+            errors.Write(queryFile);
+            errors.Write('\n');
+            return 1;
+        }
+        if (!studentFile.empty() &&
+            !runSchedules(out, studentFile, snapshot->catalog, snapshot->graph, options.creditCap, loadThreads))
+        {
+            errors.Write("Could not read students from ");
+            errors.Write(studentFile);
+            errors.Write('\n');
+            return 1;
+        }
+        return 0;
+    }
 
     while (choice != 9)
     {
+        // a finished background load is reported before the next menu, and a
+        // data file that changed on disk is reloaded while the menu keeps going
+        if (store.TakeResult(reloaded))
+        {
+            reportLoad(out, reloaded);
+        }
+        if (!store.Current()->catalog.Empty() && !store.Reloading() && store.SourceChanged(dataFile))
+        {
+            cout << "Course data changed, reloading in the background" << endl;
+            store.Reload(dataFile, loadThreads, precomputeClosure);
+        }
+
         cout << "Menu:" << endl;
         cout << "  1. Load Data Structure" << endl;
         cout << "  2. Print Course List" << endl;
         cout << "  3. Print Course" << endl;
+        cout << "  4. Print Study Plan" << endl;
+        cout << "  5. Print All Prerequisites" << endl;
+        cout << "  6. Check If A Course Requires Another" << endl;
+        cout << "  7. Print Course List By ID" << endl;
+        cout << "  8. Search Courses" << endl;
         cout << "  9. Exit" << endl;
         cout << "What would you like to do ? ";
         cin >> choice;
 
+        // every command reads one snapshot, a reload publishing meanwhile does not disturb it
+        snapshot = store.Current();
+        const CourseCatalog &courseList = snapshot->catalog;
+        const PrerequisiteGraph &graph = snapshot->graph;
+        const ClosureMatrix &closureMatrix = snapshot->closureMatrix;
+        const CourseSearch &search = snapshot->search;
+
         switch (choice)
         {
         case 1:
-            if (loadcourselist(courseList))
+            if (!store.Reload(dataFile, loadThreads, precomputeClosure))
+            {
+                cout << "Course data is already reloading" << endl;
+            }
+            else if (courseList.Empty())
             {
-                cout << "Course data loaded successfuly." << endl;
+                // nothing to show yet, so the first load is waited for
+                store.Wait();
+                store.TakeResult(reloaded);
+                reportLoad(out, reloaded);
             }
             else
             {
-                cout << "There was a problem loaded the course data, validate data file and prerequisite course2 are included" << endl;
+                cout << "Reloading course data in the background" << endl;
             }
             break;
         case 2:
-            quickSort(courseList, 0, courseList.size() - 1);
-            printCourseList(courseList);
+            printCourseList(out, courseList, CourseOrder::ByName);
+            out.Flush();
             break;
         case 3:
             cout << "What course do you want to know about? ";
             cin >> searchCourseID;
 
-            searchResult = SearchCourseListByID(courseList, searchCourseID);
+            searchResult = courseList.Find(searchCourseID);
+
+            if (searchResult == nullptr)
+            {
+                cout << "Course not found" << endl;
+            }
+            else
+            {
+                printCourse(out, courseList, *searchResult, true);
+                out.Flush();
+            }
+            break;
+        case 4:
+            printStudyPlan(out, courseList, graph);
+            out.Flush();
+            break;
+        case 5:
+            cout << "What course do you want the prerequisites of? ";
+            cin >> searchCourseID;
+
+            searchResult = courseList.Find(searchCourseID);
 
-            if (searchResult.name == "")
+            if (searchResult == nullptr)
             {
                 cout << "Course not found" << endl;
             }
             else
             {
-                printCourse(searchResult, true);
+                printAllPrerequisites(out, courseList, graph, closureMatrix, *searchResult);
+                out.Flush();
             }
             break;
+        case 6:
+            cout << "Which course are you planning? ";
+            cin >> searchCourseID;
+            cout << "Which course might it require? ";
+            cin >> prereqCourseID;
+
+            searchResult = courseList.Find(searchCourseID);
+            prereqResult = courseList.Find(prereqCourseID);
+
+            if (searchResult == nullptr || prereqResult == nullptr)
+            {
+                cout << "Course not found" << endl;
+            }
+            else if (requiresCourse(courseList, graph, closureMatrix, *searchResult, *prereqResult))
+            {
+                cout << searchCourseID << " requires " << prereqCourseID << endl;
+            }
+            else
+            {
+                cout << searchCourseID << " does not require " << prereqCourseID << endl;
+            }
+            break;
+        case 7:
+            printCourseList(out, courseList, CourseOrder::ById);
+            out.Flush();
+            break;
+        case 8:
+            cout << "Search for a course id prefix or name: ";
+            cin >> ws;
+            getline(cin, searchText);
+            printSearch(out, courseList, search, searchText, options.searchLimit);
+            out.Flush();
+            break;
         case 9:
             cout << "Thank you for using the course planner!" << endl;
             break;
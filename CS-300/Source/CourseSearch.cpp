@@ -0,0 +1,249 @@
+/*
+ * Program Name: Course Planner
+ * Author: Matthew Courts
+ * Description: prefix search over course ids and fuzzy search over names
+ */
+
+#include "CourseSearch.h"
+
+#include <algorithm>
+#include <climits>
+#include <numeric>
+#include <utility>
+
+#include "CatalogImage.h"
+
+using namespace std;
+
+/**
+ * ASCII lower case, other bytes unchanged
+ */
+static unsigned char Fold(char c)
+{
+    unsigned char byte = static_cast<unsigned char>(c);
+    return byte >= 'A' && byte <= 'Z' ? static_cast<unsigned char>(byte + ('a' - 'A')) : byte;
+}
+
+/**
+ * Case-insensitive three way compare of the first count bytes
+ */
+static int CompareFolded(string_view a, string_view b, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i == a.size() || i == b.size())
+        {
+            return (i == a.size() ? 0 : 1) - (i == b.size() ? 0 : 1);
+        }
+        int difference = Fold(a[i]) - Fold(b[i]);
+        if (difference != 0)
+        {
+            return difference;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Distinct lower case trigram codes of a string in ascending order
+ */
+static void Trigrams(string_view text, vector<uint32_t> &codes)
+{
+    codes.clear();
+    for (size_t i = 0; i + 3 <= text.size(); i++)
+    {
+        codes.push_back(uint32_t(Fold(text[i])) << 16 | uint32_t(Fold(text[i + 1])) << 8 | Fold(text[i + 2]));
+    }
+    sort(codes.begin(), codes.end());
+    codes.erase(unique(codes.begin(), codes.end()), codes.end());
+}
+
+void CourseSearch::Build(const CourseCatalog &source)
+{
+    Clear();
+    catalog = &source;
+    uint32_t courseCount = static_cast<uint32_t>(source.Size());
+
+    idOrder.resize(courseCount);
+    iota(idOrder.begin(), idOrder.end(), 0);
+    sort(idOrder.begin(), idOrder.end(), [&source](uint32_t a, uint32_t b)
+         {
+             string_view idA = source.Id(source[a]);
+             string_view idB = source.Id(source[b]);
+             int compared = CompareFolded(idA, idB, max(idA.size(), idB.size()));
+             return compared != 0 ? compared < 0 : a < b; });
+
+    // (trigram, slot) pairs, slots ascending within each trigram after the sort
+    vector<pair<uint32_t, uint32_t>> entries;
+    vector<uint32_t> codes;
+    for (uint32_t slot = 0; slot < courseCount; slot++)
+    {
+        Trigrams(source.Name(source[slot]), codes);
+        for (uint32_t code : codes)
+        {
+            entries.emplace_back(code, slot);
+        }
+    }
+    sort(entries.begin(), entries.end());
+
+    postings.reserve(entries.size());
+    for (size_t entry = 0; entry < entries.size(); entry++)
+    {
+        if (entry == 0 || entries[entry].first != entries[entry - 1].first)
+        {
+            trigrams.push_back(entries[entry].first);
+            postingOffsets.push_back(static_cast<uint32_t>(postings.size()));
+        }
+        postings.push_back(entries[entry].second);
+    }
+    postingOffsets.push_back(static_cast<uint32_t>(postings.size()));
+}
+
+void CourseSearch::Clear()
+{
+    catalog = nullptr;
+    idOrder.clear();
+    trigrams.clear();
+    postingOffsets.clear();
+    postings.clear();
+}
+
+size_t CourseSearch::ByIdPrefix(string_view prefix, size_t limit, vector<SearchMatch> &matches) const
+{
+    matches.clear();
+    if (catalog == nullptr || prefix.empty())
+    {
+        return 0;
+    }
+
+    const CourseCatalog &source = *catalog;
+    auto first = lower_bound(idOrder.begin(), idOrder.end(), prefix, [&source](uint32_t slot, string_view key)
+                             { return CompareFolded(source.Id(source[slot]), key, key.size()) < 0; });
+    auto last = upper_bound(first, idOrder.end(), prefix, [&source](string_view key, uint32_t slot)
+                            { return CompareFolded(key, source.Id(source[slot]), key.size()) < 0; });
+
+    size_t found = static_cast<size_t>(last - first);
+    for (auto it = first; it != last && matches.size() < limit; ++it)
+    {
+        matches.push_back(SearchMatch{*it, 0});
+    }
+    return found;
+}
+
+size_t CourseSearch::ByName(string_view fragment, size_t limit, vector<SearchMatch> &matches) const
+{
+    matches.clear();
+    if (catalog == nullptr || fragment.empty())
+    {
+        return 0;
+    }
+
+    const CourseCatalog &source = *catalog;
+    if (fragment.size() < 3)
+    {
+        // too short for a trigram, scan the names in load order
+        size_t found = 0;
+        for (uint32_t slot = 0; slot < source.Size(); slot++)
+        {
+            string_view name = source.Name(source[slot]);
+            for (size_t at = 0; at + fragment.size() <= name.size(); at++)
+            {
+                if (CompareFolded(name.substr(at), fragment, fragment.size()) == 0)
+                {
+                    if (found++ < limit)
+                    {
+                        matches.push_back(SearchMatch{slot, 1});
+                    }
+                    break;
+                }
+            }
+        }
+        return found;
+    }
+
+    // count hits per slot over the posting runs of every query trigram
+    vector<uint32_t> codes;
+    Trigrams(fragment, codes);
+    codes.resize(min<size_t>(codes.size(), UINT8_MAX));
+    // hit counts per slot, kept per thread so concurrent readers never share
+    // them and a query only pays for the postings it walks, the entries
+    // touched are zeroed again before returning
+    thread_local vector<uint8_t> hits;
+    thread_local vector<uint32_t> touched;
+    if (hits.size() < source.Size())
+    {
+        hits.resize(source.Size(), 0);
+    }
+    touched.clear();
+    for (uint32_t code : codes)
+    {
+        auto key = lower_bound(trigrams.begin(), trigrams.end(), code);
+        if (key == trigrams.end() || *key != code)
+        {
+            continue;
+        }
+        size_t run = static_cast<size_t>(key - trigrams.begin());
+        for (uint32_t at = postingOffsets[run]; at < postingOffsets[run + 1]; at++)
+        {
+            if (hits[postings[at]]++ == 0)
+            {
+                touched.push_back(postings[at]);
+            }
+        }
+    }
+
+    // a name has to share at least half of the fragment's trigrams
+    uint32_t minimumScore = static_cast<uint32_t>((codes.size() + 1) / 2);
+    vector<SearchMatch> candidates;
+    for (uint32_t slot : touched)
+    {
+        if (hits[slot] >= minimumScore)
+        {
+            candidates.push_back(SearchMatch{slot, hits[slot]});
+        }
+        hits[slot] = 0;
+    }
+
+    auto ranked = [&source](const SearchMatch &a, const SearchMatch &b)
+    {
+        if (a.score != b.score)
+        {
+            return a.score > b.score;
+        }
+        size_t lengthA = source.Name(source[a.slot]).size();
+        size_t lengthB = source.Name(source[b.slot]).size();
+        return lengthA != lengthB ? lengthA < lengthB : a.slot < b.slot;
+    };
+    size_t kept = min(limit, candidates.size());
+    partial_sort(candidates.begin(), candidates.begin() + kept, candidates.end(), ranked);
+    matches.assign(candidates.begin(), candidates.begin() + kept);
+    return candidates.size();
+}
+
+size_t CourseSearch::MemoryBytes() const
+{
+    return (idOrder.capacity() + trigrams.capacity() + postingOffsets.capacity() + postings.capacity()) *
+           sizeof(uint32_t);
+}
+
+void CourseSearch::Save(ImageWriter &image) const
+{
+    image.Add(idOrder);
+    image.Add(trigrams);
+    image.Add(postingOffsets);
+    image.Add(postings);
+}
+
+bool CourseSearch::Load(ImageReader &image, const CourseCatalog &source)
+{
+    catalog = &source;
+    bool loaded = image.Next(idOrder) && image.Next(trigrams) && image.Next(postingOffsets) && image.Next(postings);
+    loaded = loaded && idOrder.size() == source.Size() && postingOffsets.size() == trigrams.size() + 1 &&
+             ValidOffsets(postingOffsets, postings.size()) && AllBelow(idOrder, source.Size()) &&
+             AllBelow(postings, source.Size());
+    if (!loaded)
+    {
+        Clear();
+    }
+    return loaded;
+}
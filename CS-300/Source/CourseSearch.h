@@ -0,0 +1,96 @@
+/*
+ * Program Name: Course Planner
+ * Author: Matthew Courts
+ * Description: prefix search over course ids and fuzzy search over names
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "CourseCatalog.h"
+#include "FlatArray.h"
+
+/**
+ * One ranked search result
+ */
+struct SearchMatch
+{
+    uint32_t slot;  // catalog slot of the course
+    uint32_t score; // name trigrams matched, 0 for id prefix matches
+};
+
+/**
+ * Search indexes built once after the catalog loads. Ids are kept as slots
+ * sorted case-insensitively so a prefix is two binary searches. Names are
+ * indexed by lower case trigram: every distinct trigram owns a sorted run
+ * of the slots whose name contains it, so a fragment only touches the runs
+ * of its own trigrams. Results are ranked then cut to the caller's limit
+ * with a partial sort, so a broad query never copies every match.
+ */
+class CourseSearch
+{
+public:
+    /**
+     * Indexes every course, the catalog must outlive the index and not change
+     *
+     * @param catalog loaded catalog
+     */
+    void Build(const CourseCatalog &catalog);
+
+    void Clear();
+
+    /**
+     * Courses whose id starts with prefix, ignoring case, in id order
+     *
+     * @param prefix start of a course id such as CSCI3
+     * @param limit most matches returned
+     * @param matches receives at most limit matches
+     * @return number of courses matching, may be more than limit
+     */
+    size_t ByIdPrefix(std::string_view prefix, size_t limit, std::vector<SearchMatch> &matches) const;
+
+    /**
+     * Courses whose name shares at least half of fragment's trigrams,
+     * ignoring case. More shared trigrams rank first, then shorter names,
+     * then load order. Fragments under three characters fall back to a
+     * substring scan.
+     *
+     * @param fragment part of a course name such as algor
+     * @param limit most matches returned
+     * @param matches receives at most limit matches
+     * @return number of courses matching, may be more than limit
+     */
+    size_t ByName(std::string_view fragment, size_t limit, std::vector<SearchMatch> &matches) const;
+
+    /**
+     * @return bytes used by both indexes
+     */
+    size_t MemoryBytes() const;
+
+    /**
+     * Adds both indexes to an image
+     */
+    void Save(ImageWriter &image) const;
+
+    /**
+     * Views indexes saved in an image, nothing is copied
+     *
+     * @param image reader positioned at the index sections
+     * @param catalog catalog the indexes were built from, must outlive the index
+     * @return status if the sections were present and consistent
+     */
+    bool Load(ImageReader &image, const CourseCatalog &catalog);
+
+private:
+    const CourseCatalog *catalog = nullptr;
+
+    FlatArray<uint32_t> idOrder;
+
+    // trigram code -> slots, one run per code in ascending code order
+    FlatArray<uint32_t> trigrams;
+    FlatArray<uint32_t> postingOffsets;
+    FlatArray<uint32_t> postings;
+};
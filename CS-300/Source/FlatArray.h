@@ -0,0 +1,195 @@
+/*
+ * Program Name: Course Planner
+ * Author: Matthew Courts
+ * Description: array that either owns its elements or views mapped memory
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+/**
+ * The subset of std::vector the catalog structures use, with one extra
+ * mode: View points the array at elements someone else owns, such as a
+ * section of a mapped catalog image, without copying them. Reads work the
+ * same in both modes. The first write to a viewed array copies it into
+ * owned storage, so a structure loaded from an image can still be changed.
+ * Only plain data types belong in a FlatArray.
+ */
+template <typename T>
+class FlatArray
+{
+public:
+    FlatArray() = default;
+
+    FlatArray(std::initializer_list<T> values)
+        : owned(values)
+    {
+        Sync();
+    }
+
+    FlatArray(const FlatArray &other)
+        : owned(other.begin(), other.end())
+    {
+        Sync();
+    }
+
+    FlatArray(FlatArray &&other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    FlatArray &operator=(const FlatArray &other)
+    {
+        if (this != &other)
+        {
+            owned.assign(other.begin(), other.end());
+            viewing = false;
+            Sync();
+        }
+        return *this;
+    }
+
+    FlatArray &operator=(FlatArray &&other) noexcept
+    {
+        owned = std::move(other.owned);
+        viewing = other.viewing;
+        first = viewing ? other.first : owned.data();
+        count = other.count;
+        other.viewing = false;
+        other.Sync();
+        return *this;
+    }
+
+    /**
+     * Points the array at elements owned elsewhere, they must outlive the view
+     *
+     * @param data first element
+     * @param size number of elements
+     */
+    void View(const T *data, size_t size)
+    {
+        owned.clear();
+        owned.shrink_to_fit();
+        viewing = true;
+        first = data;
+        count = size;
+    }
+
+    bool IsView() const { return viewing; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const T *data() const { return first; }
+    const T *begin() const { return first; }
+    const T *end() const { return first + count; }
+    const T &operator[](size_t index) const { return first[index]; }
+    const T &back() const { return first[count - 1]; }
+
+    /**
+     * Heap elements held, a view holds none
+     */
+    size_t capacity() const { return viewing ? 0 : owned.capacity(); }
+
+    T *data()
+    {
+        Own();
+        return owned.data();
+    }
+    T *begin() { return data(); }
+    T *end() { return data() + count; }
+    T &operator[](size_t index) { return data()[index]; }
+
+    void push_back(const T &value)
+    {
+        Own();
+        owned.push_back(value);
+        Sync();
+    }
+
+    template <typename... Args>
+    void emplace_back(Args &&...args)
+    {
+        Own();
+        owned.emplace_back(std::forward<Args>(args)...);
+        Sync();
+    }
+
+    template <typename Iterator>
+    void append(Iterator from, Iterator to)
+    {
+        Own();
+        owned.insert(owned.end(), from, to);
+        Sync();
+    }
+
+    void assign(size_t size, const T &value)
+    {
+        owned.assign(size, value);
+        viewing = false;
+        Sync();
+    }
+
+    void resize(size_t size)
+    {
+        Own();
+        owned.resize(size);
+        Sync();
+    }
+
+    void resize(size_t size, const T &value)
+    {
+        Own();
+        owned.resize(size, value);
+        Sync();
+    }
+
+    void reserve(size_t size)
+    {
+        Own();
+        owned.reserve(size);
+        Sync();
+    }
+
+    void clear()
+    {
+        owned.clear();
+        viewing = false;
+        Sync();
+    }
+
+    void shrink_to_fit()
+    {
+        Own();
+        owned.shrink_to_fit();
+        Sync();
+    }
+
+private:
+    /**
+     * Copies viewed elements into owned storage before a write
+     */
+    void Own()
+    {
+        if (viewing)
+        {
+            owned.assign(first, first + count);
+            viewing = false;
+            Sync();
+        }
+    }
+
+    void Sync()
+    {
+        first = owned.data();
+        count = owned.size();
+    }
+
+    std::vector<T> owned;
+    const T *first = nullptr;
+    size_t count = 0;
+    bool viewing = false;
+};
@@ -0,0 +1,213 @@
+/*
+ * Program Name: Course Planner
+ * Author: Matthew Courts
+ * Description: prerequisite graph over the course catalog
+ */
+
+#include "PrerequisiteGraph.h"
+
+#include <algorithm>
+
+#include "CatalogImage.h"
+
+using namespace std;
+
+void PrerequisiteGraph::Build(const CourseCatalog &catalog)
+{
+    size_t nodeCount = catalog.Size();
+    prerequisiteOffsets.assign(nodeCount + 1, 0);
+    prerequisiteTargets.clear();
+    dependentOffsets.assign(nodeCount + 1, 0);
+
+    // course -> prerequisites, already grouped by course
+    for (size_t node = 0; node < nodeCount; node++)
+    {
+        for (uint32_t prereqId : catalog.Prerequisites(catalog[node]))
+        {
+            size_t prereq = catalog.SlotOf(prereqId);
+            if (prereq != CourseCatalog::npos)
+            {
+                prerequisiteTargets.push_back(static_cast<uint32_t>(prereq));
+                dependentOffsets[prereq + 1]++;
+            }
+        }
+        prerequisiteOffsets[node + 1] = static_cast<uint32_t>(prerequisiteTargets.size());
+    }
+
+    // prerequisite -> courses, counted above then placed with a prefix sum
+    for (size_t node = 0; node < nodeCount; node++)
+    {
+        dependentOffsets[node + 1] += dependentOffsets[node];
+    }
+    dependentTargets.assign(prerequisiteTargets.size(), 0);
+    vector<uint32_t> cursor(dependentOffsets.begin(), dependentOffsets.end() - 1);
+    for (size_t node = 0; node < nodeCount; node++)
+    {
+        for (uint32_t prereq : Prerequisites(static_cast<uint32_t>(node)))
+        {
+            dependentTargets[cursor[prereq]++] = static_cast<uint32_t>(node);
+        }
+    }
+}
+
+void PrerequisiteGraph::Save(ImageWriter &image) const
+{
+    image.Add(prerequisiteOffsets);
+    image.Add(prerequisiteTargets);
+    image.Add(dependentOffsets);
+    image.Add(dependentTargets);
+}
+
+bool PrerequisiteGraph::Load(ImageReader &image)
+{
+    bool loaded = image.Next(prerequisiteOffsets) && image.Next(prerequisiteTargets) && image.Next(dependentOffsets) &&
+                  image.Next(dependentTargets);
+    loaded = loaded && !prerequisiteOffsets.empty() && prerequisiteOffsets.size() == dependentOffsets.size() &&
+             ValidOffsets(prerequisiteOffsets, prerequisiteTargets.size()) &&
+             ValidOffsets(dependentOffsets, dependentTargets.size()) &&
+             AllBelow(prerequisiteTargets, prerequisiteOffsets.size() - 1) &&
+             AllBelow(dependentTargets, dependentOffsets.size() - 1);
+    if (!loaded)
+    {
+        prerequisiteOffsets.clear();
+        prerequisiteTargets.clear();
+        dependentOffsets.clear();
+        dependentTargets.clear();
+    }
+    return loaded;
+}
+
+size_t PrerequisiteGraph::NodeCount() const
+{
+    return prerequisiteOffsets.empty() ? 0 : prerequisiteOffsets.size() - 1;
+}
+
+PrerequisiteGraph::NodeRange PrerequisiteGraph::Prerequisites(uint32_t node) const
+{
+    const uint32_t *base = prerequisiteTargets.data();
+    return NodeRange{base + prerequisiteOffsets[node], base + prerequisiteOffsets[node + 1]};
+}
+
+PrerequisiteGraph::NodeRange PrerequisiteGraph::Dependents(uint32_t node) const
+{
+    const uint32_t *base = dependentTargets.data();
+    return NodeRange{base + dependentOffsets[node], base + dependentOffsets[node + 1]};
+}
+
+bool PrerequisiteGraph::TopologicalOrder(vector<uint32_t> &order) const
+{
+    size_t nodeCount = NodeCount();
+    vector<uint32_t> waiting(nodeCount);
+    order.clear();
+    order.reserve(nodeCount);
+
+    for (uint32_t node = 0; node < nodeCount; node++)
+    {
+        waiting[node] = static_cast<uint32_t>(Prerequisites(node).size());
+        if (waiting[node] == 0)
+        {
+            order.push_back(node);
+        }
+    }
+
+    // order doubles as the queue, everything before next has been released
+    for (size_t next = 0; next < order.size(); next++)
+    {
+        for (uint32_t dependent : Dependents(order[next]))
+        {
+            if (--waiting[dependent] == 0)
+            {
+                order.push_back(dependent);
+            }
+        }
+    }
+
+    return order.size() == nodeCount;
+}
+
+bool PrerequisiteGraph::FindCycle(vector<uint32_t> &cycle) const
+{
+    enum : char
+    {
+        Unvisited,
+        OnPath,
+        Done
+    };
+    size_t nodeCount = NodeCount();
+    vector<char> state(nodeCount, Unvisited);
+    vector<pair<uint32_t, uint32_t>> path; // node, next prerequisite edge to follow
+
+    cycle.clear();
+    for (uint32_t start = 0; start < nodeCount; start++)
+    {
+        if (state[start] != Unvisited)
+        {
+            continue;
+        }
+
+        path.emplace_back(start, prerequisiteOffsets[start]);
+        state[start] = OnPath;
+        while (!path.empty())
+        {
+            uint32_t node = path.back().first;
+            uint32_t &edge = path.back().second;
+            if (edge == prerequisiteOffsets[node + 1])
+            {
+                state[node] = Done;
+                path.pop_back();
+                continue;
+            }
+
+            uint32_t prereq = prerequisiteTargets[edge++];
+            if (state[prereq] == OnPath)
+            {
+                // the cycle is the part of the path from prereq back to here
+                auto from = find_if(path.begin(), path.end(), [prereq](const pair<uint32_t, uint32_t> &step)
+                                    { return step.first == prereq; });
+                for (; from != path.end(); ++from)
+                {
+                    cycle.push_back(from->first);
+                }
+                return true;
+            }
+            if (state[prereq] == Unvisited)
+            {
+                state[prereq] = OnPath;
+                path.emplace_back(prereq, prerequisiteOffsets[prereq]);
+            }
+        }
+    }
+    return false;
+}
+
+void PrerequisiteGraph::PrerequisiteClosure(uint32_t node, vector<uint32_t> &closure) const
+{
+    closure.clear();
+    vector<char> seen(NodeCount(), 0);
+    vector<pair<uint32_t, uint32_t>> path; // node, next prerequisite edge to follow
+
+    seen[node] = 1;
+    path.emplace_back(node, prerequisiteOffsets[node]);
+    while (!path.empty())
+    {
+        uint32_t current = path.back().first;
+        uint32_t &edge = path.back().second;
+        if (edge == prerequisiteOffsets[current + 1])
+        {
+            // post-order puts each course after its own prerequisites
+            if (current != node)
+            {
+                closure.push_back(current);
+            }
+            path.pop_back();
+            continue;
+        }
+
+        uint32_t prereq = prerequisiteTargets[edge++];
+        if (!seen[prereq])
+        {
+            seen[prereq] = 1;
+            path.emplace_back(prereq, prerequisiteOffsets[prereq]);
+        }
+    }
+}
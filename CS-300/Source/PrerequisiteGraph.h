@@ -0,0 +1,99 @@
+/*
+ * Program Name: Course Planner
+ * Author: Matthew Courts
+ * Description: prerequisite graph over the course catalog
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "CourseCatalog.h"
+#include "FlatArray.h"
+
+/**
+ * Prerequisite relationships as integer node ids (the catalog slot of each
+ * course) in compressed sparse row form: the edges of node n are
+ * targets[offsets[n] .. offsets[n + 1]). Edges are kept both ways, course to
+ * its prerequisites and prerequisite to the courses that require it.
+ * Prerequisites that are not in the catalog are left out of the graph.
+ */
+class PrerequisiteGraph
+{
+public:
+    /**
+     * Contiguous run of node ids
+     */
+    struct NodeRange
+    {
+        const uint32_t *first;
+        const uint32_t *last;
+
+        const uint32_t *begin() const { return first; }
+        const uint32_t *end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+    };
+
+    /**
+     * Builds both adjacency arrays from the catalog in linear time
+     *
+     * @param catalog loaded courses, node ids are catalog slots
+     */
+    void Build(const CourseCatalog &catalog);
+
+    size_t NodeCount() const;
+
+    /**
+     * Direct prerequisites of a course
+     */
+    NodeRange Prerequisites(uint32_t node) const;
+
+    /**
+     * Courses that directly require a course
+     */
+    NodeRange Dependents(uint32_t node) const;
+
+    /**
+     * Orders every course after all of its prerequisites (Kahn's algorithm)
+     *
+     * @param order receives the study plan
+     * @return status if the whole catalog could be ordered, false when there is a cycle
+     */
+    bool TopologicalOrder(std::vector<uint32_t> &order) const;
+
+    /**
+     * Finds a prerequisite cycle
+     *
+     * @param cycle receives the courses of one cycle, each requiring the next
+     * @return status if a cycle exists
+     */
+    bool FindCycle(std::vector<uint32_t> &cycle) const;
+
+    /**
+     * Every course required before a course, directly or transitively
+     *
+     * @param node course to resolve
+     * @param closure receives the prerequisites, each after its own prerequisites
+     */
+    void PrerequisiteClosure(uint32_t node, std::vector<uint32_t> &closure) const;
+
+    /**
+     * Adds both adjacency arrays to an image
+     */
+    void Save(ImageWriter &image) const;
+
+    /**
+     * Views a graph saved in an image, nothing is copied
+     *
+     * @param image reader positioned at the graph's sections
+     * @return status if the sections were present and consistent
+     */
+    bool Load(ImageReader &image);
+
+private:
+    FlatArray<uint32_t> prerequisiteOffsets;
+    FlatArray<uint32_t> prerequisiteTargets;
+    FlatArray<uint32_t> dependentOffsets;
+    FlatArray<uint32_t> dependentTargets;
+};
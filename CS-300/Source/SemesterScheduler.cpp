@@ -0,0 +1,170 @@
+/*
+ * Program Name: Course Planner
+ * Author: Matthew Courts
+ * Description: packs a student's courses into terms under a credit cap
+ */
+
+#include "SemesterScheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <thread>
+
+using namespace std;
+
+SemesterScheduler::SemesterScheduler(const PrerequisiteGraph &graph)
+    : graph(graph)
+{
+}
+
+bool SemesterScheduler::Plan(const vector<uint32_t> &targets, unsigned creditCap, Schedule &schedule) const
+{
+    Workspace workspace;
+    return Plan(targets, creditCap, schedule, workspace);
+}
+
+void SemesterScheduler::PlanAll(const vector<vector<uint32_t>> &targets, unsigned creditCap, unsigned threads,
+                                vector<Schedule> &schedules) const
+{
+    schedules.assign(targets.size(), Schedule());
+    if (threads == 0)
+    {
+        threads = max(thread::hardware_concurrency(), 1u);
+    }
+    threads = static_cast<unsigned>(min<size_t>(threads, max<size_t>(targets.size(), 1)));
+
+    atomic<size_t> nextStudent(0);
+    auto work = [&]()
+    {
+        Workspace workspace;
+        for (size_t student = nextStudent++; student < targets.size(); student = nextStudent++)
+        {
+            Plan(targets[student], creditCap, schedules[student], workspace);
+        }
+    };
+
+    vector<thread> workers;
+    for (unsigned worker = 1; worker < threads; worker++)
+    {
+        workers.emplace_back(work);
+    }
+    work();
+    for (thread &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+bool SemesterScheduler::Plan(const vector<uint32_t> &targets, unsigned creditCap, Schedule &schedule,
+                             Workspace &workspace) const
+{
+    size_t nodeCount = graph.NodeCount();
+    if (workspace.stamp.size() != nodeCount || workspace.current == UINT32_MAX)
+    {
+        workspace.stamp.assign(nodeCount, 0);
+        workspace.waiting.assign(nodeCount, 0);
+        workspace.height.assign(nodeCount, 0);
+        workspace.current = 0;
+    }
+    uint32_t current = ++workspace.current;
+    vector<uint32_t> &stamp = workspace.stamp;
+    vector<uint32_t> &waiting = workspace.waiting;
+    vector<uint32_t> &height = workspace.height;
+    vector<uint32_t> &needed = workspace.needed;
+    vector<uint32_t> &ready = workspace.ready;
+    vector<uint32_t> &released = workspace.released;
+    auto &path = workspace.path;
+
+    schedule.courses.clear();
+    schedule.termEnds.clear();
+    needed.clear();
+
+    // every target and everything it needs, each after its own prerequisites
+    for (uint32_t target : targets)
+    {
+        if (stamp[target] == current)
+        {
+            continue;
+        }
+        stamp[target] = current;
+        path.emplace_back(target, 0);
+        while (!path.empty())
+        {
+            uint32_t node = path.back().first;
+            PrerequisiteGraph::NodeRange prerequisites = graph.Prerequisites(node);
+            if (path.back().second == prerequisites.size())
+            {
+                needed.push_back(node);
+                path.pop_back();
+                continue;
+            }
+            uint32_t prereq = prerequisites.first[path.back().second++];
+            if (stamp[prereq] != current)
+            {
+                stamp[prereq] = current;
+                path.emplace_back(prereq, 0);
+            }
+        }
+    }
+
+    // critical path, walked from the last courses back so dependents come first
+    for (auto it = needed.rbegin(); it != needed.rend(); ++it)
+    {
+        uint32_t longest = 0;
+        for (uint32_t dependent : graph.Dependents(*it))
+        {
+            if (stamp[dependent] == current)
+            {
+                longest = max(longest, height[dependent]);
+            }
+        }
+        height[*it] = longest + 1;
+        waiting[*it] = static_cast<uint32_t>(graph.Prerequisites(*it).size());
+    }
+
+    // highest critical path first, lower node id breaks ties
+    auto lowerPriority = [&height](uint32_t a, uint32_t b)
+    {
+        return height[a] != height[b] ? height[a] < height[b] : a > b;
+    };
+    ready.clear();
+    for (uint32_t node : needed)
+    {
+        if (waiting[node] == 0)
+        {
+            ready.push_back(node);
+        }
+    }
+    make_heap(ready.begin(), ready.end(), lowerPriority);
+
+    size_t perTerm = max<size_t>(creditCap / creditsPerCourse, 1);
+    while (!ready.empty())
+    {
+        // courses released this term can only start next term
+        released.clear();
+        for (size_t taken = 0; taken < perTerm && !ready.empty(); taken++)
+        {
+            pop_heap(ready.begin(), ready.end(), lowerPriority);
+            uint32_t course = ready.back();
+            ready.pop_back();
+            schedule.courses.push_back(course);
+            for (uint32_t dependent : graph.Dependents(course))
+            {
+                if (stamp[dependent] == current && --waiting[dependent] == 0)
+                {
+                    released.push_back(dependent);
+                }
+            }
+        }
+        schedule.termEnds.push_back(static_cast<uint32_t>(schedule.courses.size()));
+        for (uint32_t course : released)
+        {
+            ready.push_back(course);
+            push_heap(ready.begin(), ready.end(), lowerPriority);
+        }
+    }
+
+    schedule.complete = schedule.courses.size() == needed.size();
+    return schedule.complete;
+}
@@ -0,0 +1,90 @@
+/*
+ * Program Name: Course Planner
+ * Author: Matthew Courts
+ * Description: packs a student's courses into terms under a credit cap
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "PrerequisiteGraph.h"
+
+/**
+ * Courses of one plan, term by term. Term t holds
+ * courses[t == 0 ? 0 : termEnds[t - 1], termEnds[t]).
+ */
+struct Schedule
+{
+    std::vector<uint32_t> courses;
+    std::vector<uint32_t> termEnds;
+    bool complete = false; // false when a prerequisite cycle blocks the plan
+
+    size_t TermCount() const { return termEnds.size(); }
+};
+
+/**
+ * List scheduling over the prerequisite graph. A plan takes the target
+ * courses and every prerequisite they need, ranks each course by its
+ * critical path (the longest chain of needed courses that depend on it),
+ * and fills each term with the highest ranked courses whose prerequisites
+ * were finished in earlier terms. The graph is only read, so any number of
+ * threads may plan at once.
+ */
+class SemesterScheduler
+{
+public:
+    // the course data has no credit hours, every course counts as a standard three
+    static const unsigned creditsPerCourse = 3;
+
+    /**
+     * @param graph prerequisite graph, must outlive the scheduler
+     */
+    explicit SemesterScheduler(const PrerequisiteGraph &graph);
+
+    /**
+     * Plans one student
+     *
+     * @param targets node ids of the courses the student wants
+     * @param creditCap most credits taken in one term
+     * @param schedule receives the plan
+     * @return status if every needed course was scheduled
+     */
+    bool Plan(const std::vector<uint32_t> &targets, unsigned creditCap, Schedule &schedule) const;
+
+    /**
+     * Plans many students on several threads. Threads take the next student
+     * from a shared counter, so uneven plans still keep every thread busy.
+     *
+     * @param targets target courses per student
+     * @param creditCap most credits taken in one term
+     * @param threads worker threads, 0 uses one per hardware thread
+     * @param schedules receives one plan per student in the same order
+     */
+    void PlanAll(const std::vector<std::vector<uint32_t>> &targets, unsigned creditCap, unsigned threads,
+                 std::vector<Schedule> &schedules) const;
+
+private:
+    /**
+     * Per thread scratch space sized to the graph. Marks carry a stamp per
+     * plan so nothing is cleared between students.
+     */
+    struct Workspace
+    {
+        std::vector<uint32_t> stamp;
+        std::vector<uint32_t> waiting;
+        std::vector<uint32_t> height;
+        std::vector<uint32_t> needed;
+        std::vector<uint32_t> ready;
+        std::vector<uint32_t> released;
+        std::vector<std::pair<uint32_t, uint32_t>> path;
+        uint32_t current = 0;
+    };
+
+    bool Plan(const std::vector<uint32_t> &targets, unsigned creditCap, Schedule &schedule,
+              Workspace &workspace) const;
+
+    const PrerequisiteGraph &graph;
+};
@@ -0,0 +1,174 @@
+/*
+ * Program Name: Course Planner
+ * Author: Matthew Courts
+ * Description: interned strings addressed by 32 bit handles
+ */
+
+#include "StringPool.h"
+
+#include <vector>
+
+#include "CatalogImage.h"
+
+using namespace std;
+
+uint32_t StringPool::Intern(string_view value)
+{
+    // keep the table at most half full
+    if ((Size() + 1) * 2 > table.size())
+    {
+        Grow();
+    }
+
+    uint32_t hash = Hash(value);
+    size_t bucket = Probe(value, hash);
+    if (table[bucket] != 0)
+    {
+        return table[bucket] - 1;
+    }
+
+    uint32_t handle = static_cast<uint32_t>(Size());
+    text.append(value.begin(), value.end());
+    offsets.push_back(static_cast<uint32_t>(text.size()));
+    hashes.push_back(hash);
+    table[bucket] = handle + 1;
+    return handle;
+}
+
+uint32_t StringPool::Find(string_view value) const
+{
+    if (table.empty())
+    {
+        return npos;
+    }
+    size_t bucket = Probe(value, Hash(value));
+    return table[bucket] - 1;
+}
+
+string_view StringPool::View(uint32_t handle) const
+{
+    return string_view(text.data() + offsets[handle], offsets[handle + 1] - offsets[handle]);
+}
+
+size_t StringPool::Size() const
+{
+    return hashes.size();
+}
+
+void StringPool::Clear()
+{
+    text.clear();
+    offsets.assign(1, 0);
+    hashes.clear();
+    table.clear();
+}
+
+size_t StringPool::MemoryBytes() const
+{
+    return text.capacity() + (offsets.capacity() + hashes.capacity() + table.capacity()) * sizeof(uint32_t);
+}
+
+void StringPool::Save(ImageWriter &image) const
+{
+    image.Add(text);
+    image.Add(offsets);
+    image.Add(hashes);
+    image.Add(table);
+}
+
+bool StringPool::Load(ImageReader &image)
+{
+    if (!image.Next(text) || !image.Next(offsets) || !image.Next(hashes) || !image.Next(table))
+    {
+        Clear();
+        return false;
+    }
+
+    // the table size must be a power of two with room left for probing to stop
+    size_t buckets = table.size();
+    bool tableValid = buckets == 0 ? hashes.empty() : (buckets & (buckets - 1)) == 0 && hashes.size() * 2 <= buckets;
+    // table entries are handle + 1, 0 for an empty bucket
+    if (offsets.size() != hashes.size() + 1 || !ValidOffsets(offsets, text.size()) || !tableValid ||
+        !AllBelow(table, hashes.size() + 1) || !ValidTable())
+    {
+        Clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Checks that every handle sits in exactly one bucket and that an empty
+ * bucket is left, otherwise Probe could loop forever on a full table
+ *
+ * @return status if the table can be probed
+ */
+bool StringPool::ValidTable() const
+{
+    vector<char> placed(hashes.size(), 0);
+    size_t used = 0;
+    for (uint32_t entry : table)
+    {
+        if (entry == 0)
+        {
+            continue;
+        }
+        if (placed[entry - 1])
+        {
+            return false;
+        }
+        placed[entry - 1] = 1;
+        used++;
+    }
+    return used == hashes.size() && used < table.size();
+}
+
+/**
+ * 32 bit FNV-1a
+ */
+uint32_t StringPool::Hash(string_view value)
+{
+    uint32_t hash = 2166136261u;
+    for (char c : value)
+    {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Linear probe for a string
+ *
+ * @return bucket holding the string, or the empty bucket where it belongs
+ */
+size_t StringPool::Probe(string_view value, uint32_t hash) const
+{
+    size_t mask = table.size() - 1;
+    for (size_t bucket = hash & mask;; bucket = (bucket + 1) & mask)
+    {
+        uint32_t entry = table[bucket];
+        if (entry == 0 || (hashes[entry - 1] == hash && View(entry - 1) == value))
+        {
+            return bucket;
+        }
+    }
+}
+
+/**
+ * Doubles the table and reinserts every handle from its stored hash
+ */
+void StringPool::Grow()
+{
+    size_t capacity = table.empty() ? 64 : table.size() * 2;
+    table.assign(capacity, 0);
+    size_t mask = capacity - 1;
+    for (uint32_t handle = 0; handle < Size(); handle++)
+    {
+        size_t bucket = hashes[handle] & mask;
+        while (table[bucket] != 0)
+        {
+            bucket = (bucket + 1) & mask;
+        }
+        table[bucket] = handle + 1;
+    }
+}
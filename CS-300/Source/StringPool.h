@@ -0,0 +1,87 @@
+/*
+ * Program Name: Course Planner
+ * Author: Matthew Courts
+ * Description: interned strings addressed by 32 bit handles
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "FlatArray.h"
+
+class ImageReader;
+class ImageWriter;
+
+/**
+ * Every distinct string is stored once, back to back in one character
+ * buffer, and is named by a dense 32 bit handle in insertion order. An open
+ * addressing table of handles finds an existing copy, so equal strings
+ * always share a handle and can be compared by handle alone.
+ */
+class StringPool
+{
+public:
+    static const uint32_t npos = static_cast<uint32_t>(-1);
+
+    /**
+     * Handle of a string, adding it on first use
+     *
+     * @param text string to intern
+     * @return handle shared by every equal string
+     */
+    uint32_t Intern(std::string_view text);
+
+    /**
+     * Handle of a string without adding it
+     *
+     * @param text string being searched for
+     * @return handle of the string, npos if it was never interned
+     */
+    uint32_t Find(std::string_view text) const;
+
+    /**
+     * Text of a handle, valid until the next Intern or Clear
+     *
+     * @param handle handle returned by Intern
+     * @return view into the pool
+     */
+    std::string_view View(uint32_t handle) const;
+
+    /**
+     * @return number of distinct strings
+     */
+    size_t Size() const;
+
+    void Clear();
+
+    /**
+     * @return bytes used by text, offsets and the hash table
+     */
+    size_t MemoryBytes() const;
+
+    /**
+     * Adds the text, offsets, hashes and table to an image
+     */
+    void Save(ImageWriter &image) const;
+
+    /**
+     * Views the pool saved in an image, nothing is copied
+     *
+     * @param image reader positioned at the pool's sections
+     * @return status if the sections were present and consistent
+     */
+    bool Load(ImageReader &image);
+
+private:
+    static uint32_t Hash(std::string_view text);
+    size_t Probe(std::string_view text, uint32_t hash) const;
+    void Grow();
+    bool ValidTable() const;
+
+    FlatArray<char> text;
+    FlatArray<uint32_t> offsets = {0}; // string h is text[offsets[h], offsets[h + 1])
+    FlatArray<uint32_t> hashes;        // per handle, so growing does not rehash text
+    FlatArray<uint32_t> table;         // handle + 1 per bucket, 0 is empty
+};
@@ -1,5 +1,6 @@
 #include <iostream>         // error handling and output
 #include <cstdlib>          // EXIT_FAILURE
+#include <cstdio>           // snprintf
 
 #include <GL/glew.h>        // GLEW library
 #include "GLFW/glfw3.h"     // GLFW library
@@ -87,6 +88,11 @@ int main(int argc, char* argv[])
 	std::cout << "Mouse Wheel Up - move faster \t" << "Mouse Wheel Down - move slower\n";
 
 
+	// frame counter for the render statistics in the window title
+	int framesCounted = 0;
+	double statsStartTime = glfwGetTime();
+	char windowTitle[160];
+
 	// loop will keep running until the application is closed 
 	// or until an error has occurred
 	while (!glfwWindowShouldClose(g_Window))
@@ -104,6 +110,21 @@ int main(int argc, char* argv[])
 		// refresh the 3D scene
 		g_SceneManager->RenderScene();
 
+		// once a second show the frame rate and the draw calls
+		// of the last frame in the window title
+		framesCounted++;
+		double currentTime = glfwGetTime();
+		if (currentTime - statsStartTime >= 1.0)
+		{
+			const RenderStats& stats = g_SceneManager->GetRenderStats();
+			snprintf(windowTitle, sizeof(windowTitle), "%s - %.0f fps, %d draw calls, %d state changes",
+				WINDOW_TITLE, framesCounted / (currentTime - statsStartTime),
+				stats.DrawCalls, stats.StateChanges);
+			glfwSetWindowTitle(g_Window, windowTitle);
+			framesCounted = 0;
+			statsStartTime = currentTime;
+		}
+
 
 		// Flips the the back buffer with the front buffer every frame.
 		glfwSwapBuffers(g_Window);
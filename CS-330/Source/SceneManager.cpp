@@ -24,6 +24,17 @@ namespace
 	const char* g_TextureValueName = "objectTexture";
 	const char* g_UseTextureName = "bUseTexture";
 	const char* g_UseLightingName = "bUseLighting";
+
+	// material uniform names are longer than the small string
+	// buffer, keep them as strings so uploads do not allocate
+	const std::string g_MaterialAmbientColorName = "material.ambientColor";
+	const std::string g_MaterialAmbientStrengthName = "material.ambientStrength";
+	const std::string g_MaterialDiffuseColorName = "material.diffuseColor";
+	const std::string g_MaterialSpecularColorName = "material.specularColor";
+	const std::string g_MaterialShininessName = "material.shininess";
+
+	// number of entries in MESHLIST
+	const int g_MeshTypeCount = static_cast<int>(MESHLIST::HalfTorus) + 1;
 }
 
 /***********************************************************
@@ -35,6 +46,7 @@ SceneManager::SceneManager(ShaderManager *pShaderManager)
 {
 	m_pShaderManager = pShaderManager;
 	m_basicMeshes = new ShapeMeshes();
+	m_sceneDirty = true;
 }
 
 /***********************************************************
@@ -241,12 +253,31 @@ bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
 }
 
 /***********************************************************
- *  SetTransformations()
+ *  FindMaterialIndex()
  *
- *  This method is used for setting the transform buffer
- *  using the passed in transformation values.
+ *  This method is used for getting the index of a previously
+ *  defined material, or -1 when no material has the tag.
  ***********************************************************/
-void SceneManager::SetTransformations(
+int SceneManager::FindMaterialIndex(std::string tag)
+{
+	for (int index = 0; index < (int)m_objectMaterials.size(); index++)
+	{
+		if (m_objectMaterials[index].tag.compare(tag) == 0)
+		{
+			return(index);
+		}
+	}
+
+	return(-1);
+}
+
+/***********************************************************
+ *  ComputeModelMatrix()
+ *
+ *  This method is used for building the model matrix
+ *  from the passed in transformation values.
+ ***********************************************************/
+glm::mat4 SceneManager::ComputeModelMatrix(
 	glm::vec3 scaleXYZ,
 	float XrotationDegrees,
 	float YrotationDegrees,
@@ -254,7 +285,6 @@ void SceneManager::SetTransformations(
 	glm::vec3 positionXYZ)
 {
 	// variables for this method
-	glm::mat4 modelView;
 	glm::mat4 scale;
 	glm::mat4 rotationX;
 	glm::mat4 rotationY;
@@ -270,8 +300,29 @@ void SceneManager::SetTransformations(
 	// set the translation value in the transform buffer
 	translation = glm::translate(positionXYZ);
 
-	 //modelView = translation * rotationX * rotationY * rotationZ * scale; 
-	modelView = translation * rotationZ * rotationY * rotationX * scale;
+	 //return translation * rotationX * rotationY * rotationZ * scale; 
+	return translation * rotationZ * rotationY * rotationX * scale;
+}
+
+/***********************************************************
+ *  SetTransformations()
+ *
+ *  This method is used for setting the transform buffer
+ *  using the passed in transformation values.
+ ***********************************************************/
+void SceneManager::SetTransformations(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	glm::mat4 modelView = ComputeModelMatrix(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
 
 	if (NULL != m_pShaderManager)
 	{
@@ -572,58 +623,330 @@ void SceneManager::PrepareScene()
 	m_basicMeshes->LoadPyramid3Mesh();
 	m_basicMeshes->LoadBoxMesh();
 
+	// add the objects once, every frame draws the same list
+	m_sceneObjects.clear();
+	AddPlane();
+	AddWoodBase();
+	AddCoffeeCup();
+	AddPitcher();
+	AddKettle();
+	AddCarafe();
+	//AxisReference();
+	BuildDrawList();
+}
+
+/***********************************************************
+ *  AddObjectList()
+ *
+ *  This method is for adding vector containing a list
+ *  of objects centered around a location to the scene.
+ *  The draw list is rebuilt before the next frame.
+ ***********************************************************/
+void SceneManager::AddObjectList(const std::vector<RenderData>& AssetList)
+{
+	m_sceneObjects.insert(m_sceneObjects.end(), AssetList.begin(), AssetList.end());
+	m_sceneDirty = true;
+}
+
+/***********************************************************
+ *  UpdateSceneObject()
+ *
+ *  This method is used for replacing one object of the
+ *  scene, by the position it was added in.  The scene is
+ *  marked for rebuilding before the next frame.
+ ***********************************************************/
+bool SceneManager::UpdateSceneObject(size_t index, const RenderData& object)
+{
+	if (index >= m_sceneObjects.size())
+	{
+		return(false);
+	}
+
+	m_sceneObjects[index] = object;
+	m_sceneDirty = true;
+	return(true);
+}
+
+/***********************************************************
+ *  GetSceneObjectCount()
+ *
+ *  This method is used for getting the number of objects
+ *  added to the scene.
+ ***********************************************************/
+size_t SceneManager::GetSceneObjectCount() const
+{
+	return(m_sceneObjects.size());
+}
+
+/***********************************************************
+ *  QueueObject()
+ *
+ *  This method is used for queueing one object with its
+ *  model matrix and the shader settings it ends up with.
+ ***********************************************************/
+void SceneManager::QueueObject(const RenderData& Asset)
+{
+	//Resolve Color, Texture, UVScale, and Material the same way
+	//the shader would see them if the object were drawn now
+	if (Asset.ShaderColor != glm::vec4{})
+	{
+		m_currentState.ShaderColor = Asset.ShaderColor;
+		m_currentState.HasColor = true;
+		m_currentState.UseTexture = 0;
+	}
+	if (Asset.ShaderTexture != "")
+	{
+		m_currentState.TextureSlot = FindTextureSlot(Asset.ShaderTexture);
+		m_currentState.UseTexture = 1;
+	}
+	if (Asset.TextureUVScale != glm::vec2{})
+	{
+		m_currentState.TextureUVScale = Asset.TextureUVScale;
+		m_currentState.HasUVScale = true;
+	}
+	if (Asset.ShaderMaterial != "")
+	{
+		m_currentState.MaterialIndex = FindMaterialIndex(Asset.ShaderMaterial);
+	}
+
+	QueuedDraw draw;
+	draw.model = ComputeModelMatrix(
+		Asset.scaleXYZ,
+		Asset.XrotationDegrees,
+		Asset.YrotationDegrees,
+		Asset.ZrotationDegrees,
+		Asset.positionXYZ
+	);
+	draw.meshType = Asset.MeshType;
+	draw.stateIndex = InternRenderState(m_currentState);
+	// see through colors blend with whatever was drawn behind them
+	draw.blended = m_currentState.UseTexture != 1 && m_currentState.HasColor && m_currentState.ShaderColor.a < 1.0f;
+	m_drawQueue.push_back(draw);
+}
+
+/***********************************************************
+ *  InternRenderState()
+ *
+ *  This method is used for finding a shader state in the
+ *  list of states seen so far, adding it when it is new.
+ *  A scene only uses a handful of states.
+ ***********************************************************/
+int SceneManager::InternRenderState(const RenderState& state)
+{
+	for (int index = 0; index < (int)m_renderStates.size(); index++)
+	{
+		if (m_renderStates[index] == state)
+		{
+			return(index);
+		}
+	}
+
+	m_renderStates.push_back(state);
+	return((int)m_renderStates.size() - 1);
+}
+
+/***********************************************************
+ *  ApplyRenderState()
+ *
+ *  This method is used for passing a resolved shader state
+ *  into the shader. Settings that were never made are left
+ *  as they are.
+ ***********************************************************/
+void SceneManager::ApplyRenderState(const RenderState& state)
+{
+	if (NULL == m_pShaderManager)
+	{
+		return;
+	}
+
+	if (state.HasColor)
+	{
+		m_pShaderManager->setVec4Value(g_ColorValueName, state.ShaderColor);
+	}
+	if (state.TextureSlot >= 0)
+	{
+		m_pShaderManager->setSampler2DValue(g_TextureValueName, state.TextureSlot);
+	}
+	if (state.UseTexture >= 0)
+	{
+		m_pShaderManager->setIntValue(g_UseTextureName, state.UseTexture == 1);
+	}
+	if (state.HasUVScale)
+	{
+		SetTextureUVScale(state.TextureUVScale);
+	}
+	if (state.MaterialIndex >= 0)
+	{
+		const OBJECT_MATERIAL& material = m_objectMaterials[state.MaterialIndex];
+		m_pShaderManager->setVec3Value(g_MaterialAmbientColorName, material.ambientColor);
+		m_pShaderManager->setFloatValue(g_MaterialAmbientStrengthName, material.ambientStrength);
+		m_pShaderManager->setVec3Value(g_MaterialDiffuseColorName, material.diffuseColor);
+		m_pShaderManager->setVec3Value(g_MaterialSpecularColorName, material.specularColor);
+		m_pShaderManager->setFloatValue(g_MaterialShininessName, material.shininess);
+	}
+}
+
+/***********************************************************
+ *  DrawMesh()
+ *
+ *  This method is used for drawing one mesh of the passed
+ *  in type with the current transform and shader settings.
+ ***********************************************************/
+void SceneManager::DrawMesh(MESHLIST meshType)
+{
+	switch (meshType)
+	{
+	case MESHLIST::Box: m_basicMeshes->DrawBoxMesh();  break;
+	case MESHLIST::Cone: m_basicMeshes->DrawConeMesh();  break;
+	case MESHLIST::ConeNoBottom: m_basicMeshes->DrawConeMesh(false); break;
+	case MESHLIST::Cylinder: m_basicMeshes->DrawCylinderMesh(); break;
+	case MESHLIST::CylinderNoTop: m_basicMeshes->DrawCylinderMesh(false, true, true); break;
+	case MESHLIST::CylinderNoBottom: m_basicMeshes->DrawCylinderMesh(true, false, true); break;
+	case MESHLIST::CylinderOpen: m_basicMeshes->DrawCylinderMesh(false, false, true); break;
+	case MESHLIST::Plane: m_basicMeshes->DrawPlaneMesh(); break;
+	case MESHLIST::Prism: m_basicMeshes->DrawPrismMesh(); break;
+	case MESHLIST::Pyramid3: m_basicMeshes->DrawPyramid3Mesh(); break;
+	case MESHLIST::Pyramid4: m_basicMeshes->DrawPyramid4Mesh(); break;
+	case MESHLIST::Sphere: m_basicMeshes->DrawSphereMesh(); break;
+	case MESHLIST::HalfSphere: m_basicMeshes->DrawHalfSphereMesh(); break;
+	case MESHLIST::TaperedCylinder: m_basicMeshes->DrawTaperedCylinderMesh(); break;
+	case MESHLIST::TaperedCylinderNoTop: m_basicMeshes->DrawTaperedCylinderMesh(false, true, true); break;
+	case MESHLIST::TaperedCylinderNoBottom: m_basicMeshes->DrawTaperedCylinderMesh(true, false, true); break;
+	case MESHLIST::TaperedCylinderOpen: m_basicMeshes->DrawTaperedCylinderMesh(false, false, true); break;
+	case MESHLIST::Torus: m_basicMeshes->DrawTorusMesh(); break;
+	case MESHLIST::HalfTorus: m_basicMeshes->DrawHalfTorusMesh(); break;
+	}
+}
+
+/***********************************************************
+ *  BuildDrawList()
+ *
+ *  This method is used for resolving every scene object
+ *  into the draw list drawn each frame.  The objects are
+ *  resolved twice, the second pass starting from the shader
+ *  settings the first pass ended with, since that is what
+ *  each frame inherits from the frame before it.  States
+ *  are collected again on the second pass so the list only
+ *  holds the states the current draws use.
+ ***********************************************************/
+void SceneManager::BuildDrawList()
+{
+	m_currentState = RenderState();
+	for (int pass = 0; pass < 2; pass++)
+	{
+		m_renderStates.clear();
+		m_drawQueue.clear();
+		for (const RenderData& Asset : m_sceneObjects)
+		{
+			QueueObject(Asset);
+		}
+	}
+
+	SortDrawQueue();
+	m_sceneDraws.clear();
+	for (int index : m_drawOrder)
+	{
+		m_sceneDraws.push_back(m_drawQueue[index]);
+	}
+	m_drawQueue.clear();
+	m_sceneDirty = false;
+}
+
+/***********************************************************
+ *  SortDrawQueue()
+ *
+ *  This method is used for ordering the queued draws. Opaque
+ *  meshes are grouped by mesh type and shader state, groups
+ *  in the order they first appeared, so each group uploads
+ *  its shader state once and then only changes the model
+ *  matrix between draws. See through meshes follow in the
+ *  order they were queued so blending stays correct.
+ ***********************************************************/
+void SceneManager::SortDrawQueue()
+{
+	int stateCount = (int)m_renderStates.size();
+	m_groupOfKey.assign(g_MeshTypeCount * stateCount, -1);
+	m_groupStart.clear();
+
+	// count the opaque draws of each mesh and state pair
+	for (const QueuedDraw& draw : m_drawQueue)
+	{
+		if (draw.blended)
+		{
+			continue;
+		}
+		int key = (int)draw.meshType * stateCount + draw.stateIndex;
+		if (m_groupOfKey[key] < 0)
+		{
+			m_groupOfKey[key] = (int)m_groupStart.size();
+			m_groupStart.push_back(0);
+		}
+		m_groupStart[m_groupOfKey[key]]++;
+	}
+
+	// turn the counts into starting positions and place each draw
+	int position = 0;
+	for (int& start : m_groupStart)
+	{
+		int count = start;
+		start = position;
+		position += count;
+	}
+	m_drawOrder.resize(m_drawQueue.size());
+	for (int index = 0; index < (int)m_drawQueue.size(); index++)
+	{
+		const QueuedDraw& draw = m_drawQueue[index];
+		if (draw.blended)
+		{
+			m_drawOrder[position++] = index;
+		}
+		else
+		{
+			int key = (int)draw.meshType * stateCount + draw.stateIndex;
+			m_drawOrder[m_groupStart[m_groupOfKey[key]]++] = index;
+		}
+	}
 }
 
 /***********************************************************
- *  RenderList()
+ *  DrawScene()
  *
- *  This method is for rendering vector containing a list
- *  of objects centered around a location.
+ *  This method is used for drawing the built draw list, one
+ *  pass over contiguous draws with no allocations.
  ***********************************************************/
-void SceneManager::RenderList(std::vector<RenderData> AssetList)
+void SceneManager::DrawScene()
 {
-	for (RenderData Asset : AssetList)
+	m_frameStats = RenderStats();
+	int lastState = -1;
+	for (const QueuedDraw& draw : m_sceneDraws)
 	{
-		// set the transformations into memory to be used on the drawn meshes
-		SetTransformations(
-			Asset.scaleXYZ,
-			Asset.XrotationDegrees,
-			Asset.YrotationDegrees,
-			Asset.ZrotationDegrees,
-			Asset.positionXYZ
-		);
-
-		//Set Color, Texture, UVScale, and Material
-		if (Asset.ShaderColor != glm::vec4{}) { SetShaderColor(Asset.ShaderColor); }
-		if (Asset.ShaderTexture != "") { SetShaderTexture(Asset.ShaderTexture); }
-		if (Asset.TextureUVScale != glm::vec2{}) { SetTextureUVScale(Asset.TextureUVScale); }
-		if (Asset.ShaderMaterial != "") { SetShaderMaterial(Asset.ShaderMaterial); }
-
-		switch (Asset.MeshType)
+		if (draw.stateIndex != lastState)
+		{
+			ApplyRenderState(m_renderStates[draw.stateIndex]);
+			m_frameStats.StateChanges++;
+		}
+		lastState = draw.stateIndex;
+
+		if (NULL != m_pShaderManager)
 		{
-		case MESHLIST::Box: m_basicMeshes->DrawBoxMesh();  break;
-		case MESHLIST::Cone: m_basicMeshes->DrawConeMesh();  break;
-		case MESHLIST::ConeNoBottom: m_basicMeshes->DrawConeMesh(false); break;
-		case MESHLIST::Cylinder: m_basicMeshes->DrawCylinderMesh(); break;
-		case MESHLIST::CylinderNoTop: m_basicMeshes->DrawCylinderMesh(false, true, true); break;
-		case MESHLIST::CylinderNoBottom: m_basicMeshes->DrawCylinderMesh(true, false, true); break;
-		case MESHLIST::CylinderOpen: m_basicMeshes->DrawCylinderMesh(false, false, true); break;
-		case MESHLIST::Plane: m_basicMeshes->DrawPlaneMesh(); break;
-		case MESHLIST::Prism: m_basicMeshes->DrawPrismMesh(); break;
-		case MESHLIST::Pyramid3: m_basicMeshes->DrawPyramid3Mesh(); break;
-		case MESHLIST::Pyramid4: m_basicMeshes->DrawPyramid4Mesh(); break;
-		case MESHLIST::Sphere: m_basicMeshes->DrawSphereMesh(); break;
-		case MESHLIST::HalfSphere: m_basicMeshes->DrawHalfSphereMesh(); break;
-		case MESHLIST::TaperedCylinder: m_basicMeshes->DrawTaperedCylinderMesh(); break;
-		case MESHLIST::TaperedCylinderNoTop: m_basicMeshes->DrawTaperedCylinderMesh(false, true, true); break;
-		case MESHLIST::TaperedCylinderNoBottom: m_basicMeshes->DrawTaperedCylinderMesh(true, false, true); break;
-		case MESHLIST::TaperedCylinderOpen: m_basicMeshes->DrawTaperedCylinderMesh(false, false, true); break;
-		case MESHLIST::Torus: m_basicMeshes->DrawTorusMesh(); break;
-		case MESHLIST::HalfTorus: m_basicMeshes->DrawHalfTorusMesh(); break;
+			m_pShaderManager->setMat4Value(g_ModelName, draw.model);
 		}
+		DrawMesh(draw.meshType);
+		m_frameStats.DrawCalls++;
 	}
 }
 
+/***********************************************************
+ *  GetRenderStats()
+ *
+ *  This method is used for getting the counters of the
+ *  last rendered frame.
+ ***********************************************************/
+const RenderStats& SceneManager::GetRenderStats() const
+{
+	return(m_frameStats);
+}
+
 /***********************************************************
  *  RenderScene()
  *
@@ -632,20 +955,21 @@ void SceneManager::RenderList(std::vector<RenderData> AssetList)
  ***********************************************************/
 void SceneManager::RenderScene()
 {
-	RenderPlane();
-	RenderWoodBase();
-	RenderCoffeeCup();
-	RenderPitcher();
-	RenderKettle();
-	RenderCarafe();
-	//AxisReference();
+	// the objects were added in PrepareScene, only rebuild
+	// the draw list when one of them has changed
+	if (m_sceneDirty)
+	{
+		BuildDrawList();
+	}
+
+	DrawScene();
 }
 
 /***********************************************************
  *  AxisReference()
  *
- *  This method is used for rendering the 3D scene by
- *  transforming and drawing the basic 3D shapes
+ *  This method is used for adding colored axis markers
+ *  to the scene for reference while placing objects
  ***********************************************************/
 void SceneManager::AxisReference()
 {
@@ -695,18 +1019,18 @@ void SceneManager::AxisReference()
 	ZAxis.MeshType = MESHLIST::Box;
 	ShapeList.push_back(ZAxis);
 
-	//render stack at given location
-	RenderList(ShapeList);
+	//add stack to the scene at given location
+	AddObjectList(ShapeList);
 
 }
 
 /***********************************************************
- *  RenderPlane()
+ *  AddPlane()
  *
- *  This method is used for rendering the 3D scene by 
- *  transforming and drawing the basic 3D shapes
+ *  This method is used for adding the basic 3D shapes of
+ *  this object to the scene
  ***********************************************************/
-void SceneManager::RenderPlane()
+void SceneManager::AddPlane()
 {
 	//Stack containing objects for rendering shape
 	std::vector<RenderData> ShapeList;
@@ -722,18 +1046,18 @@ void SceneManager::RenderPlane()
 	Plane.MeshType = MESHLIST::Plane;
 	ShapeList.push_back(Plane);
 
-	//render stack at given location
-	RenderList(ShapeList);
+	//add stack to the scene at given location
+	AddObjectList(ShapeList);
 
 }
 
 /***********************************************************
- *  RenderWoodBase()
+ *  AddWoodBase()
  *
- *  This method is used for rendering the 3D scene by 
- *  transforming and drawing the basic 3D shapes
+ *  This method is used for adding the basic 3D shapes of
+ *  this object to the scene
  ***********************************************************/
-void SceneManager::RenderWoodBase()
+void SceneManager::AddWoodBase()
 {
 
 	//Stack containing objects for rendering shape
@@ -752,18 +1076,18 @@ void SceneManager::RenderWoodBase()
 	WoodBase.MeshType = MESHLIST::Cylinder;
 	ShapeList.push_back(WoodBase);
 
-	//render stack at given location
-	RenderList(ShapeList);
+	//add stack to the scene at given location
+	AddObjectList(ShapeList);
 
 }
 
 /***********************************************************
- *  RenderCoffeeCup()
+ *  AddCoffeeCup()
  *
- *  This method is used for rendering the 3D scene by
- *  transforming and drawing the basic 3D shapes
+ *  This method is used for adding the basic 3D shapes of
+ *  this object to the scene
  ***********************************************************/
-void SceneManager::RenderCoffeeCup()
+void SceneManager::AddCoffeeCup()
 {
 	//Stack containing objects for rendering shape
 	std::vector<RenderData> ShapeList;
@@ -828,19 +1152,19 @@ void SceneManager::RenderCoffeeCup()
 	CupHandle.MeshType = MESHLIST::HalfTorus;
 	ShapeList.push_back(CupHandle);
 	
-	//render stack at given location
-	RenderList(ShapeList);
+	//add stack to the scene at given location
+	AddObjectList(ShapeList);
 
 }
 
 
 /***********************************************************
- *  RenderPitcher()
+ *  AddPitcher()
  *
- *  This method is used for rendering the 3D scene by
- *  transforming and drawing the basic 3D shapes
+ *  This method is used for adding the basic 3D shapes of
+ *  this object to the scene
  ***********************************************************/
-void SceneManager::RenderPitcher()
+void SceneManager::AddPitcher()
 {
 
 	//Stack containing objects for rendering shape
@@ -919,19 +1243,19 @@ void SceneManager::RenderPitcher()
 	PitcherHandle.MeshType = MESHLIST::HalfTorus;
 	ShapeList.push_back(PitcherHandle);
 
-	//render stack at given location
-	RenderList(ShapeList);
+	//add stack to the scene at given location
+	AddObjectList(ShapeList);
 
 }
 
 
 /***********************************************************
- *  RenderCarafe()
+ *  AddCarafe()
  *
- *  This method is used for rendering the 3D scene by
- *  transforming and drawing the basic 3D shapes
+ *  This method is used for adding the basic 3D shapes of
+ *  this object to the scene
  ***********************************************************/
-void SceneManager::RenderCarafe()
+void SceneManager::AddCarafe()
 {
 
 	//Stack containing objects for rendering shape
@@ -1011,18 +1335,18 @@ void SceneManager::RenderCarafe()
 	ShapeList.push_back(CarafeHandleTop);
 
 
-	//render stack at given location
-	RenderList(ShapeList);
+	//add stack to the scene at given location
+	AddObjectList(ShapeList);
 
 }
 
 /***********************************************************
- *  RenderKettle()
+ *  AddKettle()
  *
- *  This method is used for rendering the 3D scene by
- *  transforming and drawing the basic 3D shapes
+ *  This method is used for adding the basic 3D shapes of
+ *  this object to the scene
  ***********************************************************/
-void SceneManager::RenderKettle()
+void SceneManager::AddKettle()
 {
 
 	//Stack containing objects for rendering shape
@@ -1185,7 +1509,7 @@ void SceneManager::RenderKettle()
 	KettleGooseNeckTop.MeshType = MESHLIST::Cylinder;
 	ShapeList.push_back(KettleGooseNeckTop);
 
-	//render stack at given location
-	RenderList(ShapeList);
+	//add stack to the scene at given location
+	AddObjectList(ShapeList);
 
 }
\ No newline at end of file
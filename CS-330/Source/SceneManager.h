@@ -71,6 +71,41 @@ struct RenderData {
 
 };
 
+/***********************************************************
+ *  RenderState
+ *
+ *  This struct contains the shader settings in effect for
+ *  one draw, the settings a RenderData entry sets plus the
+ *  ones it inherits from the entries drawn before it
+ ***********************************************************/
+struct RenderState {
+	glm::vec4 ShaderColor = glm::vec4(0.0f);
+	glm::vec2 TextureUVScale = glm::vec2(0.0f);
+	int TextureSlot = -1;	// -1 when never set
+	int MaterialIndex = -1;	// -1 when never set
+	int UseTexture = -1;	// -1 when never set, 0 color, 1 texture
+	bool HasColor = false;
+	bool HasUVScale = false;
+
+	bool operator==(const RenderState& other) const
+	{
+		return ShaderColor == other.ShaderColor && TextureUVScale == other.TextureUVScale &&
+			TextureSlot == other.TextureSlot && MaterialIndex == other.MaterialIndex &&
+			UseTexture == other.UseTexture && HasColor == other.HasColor && HasUVScale == other.HasUVScale;
+	}
+};
+
+/***********************************************************
+ *  RenderStats
+ *
+ *  This struct contains the counters for the last
+ *  rendered frame
+ ***********************************************************/
+struct RenderStats {
+	int DrawCalls = 0;		// mesh draw calls issued, one per object
+	int StateChanges = 0;	// shader state uploads
+};
+
 /***********************************************************
  *  SceneManager
  *
@@ -103,6 +138,20 @@ public:
 
 
 private:
+	/***********************************************************
+	 *  QueuedDraw
+	 *
+	 *  One mesh of the draw list, with its model matrix
+	 *  and shader state already resolved
+	 ***********************************************************/
+	struct QueuedDraw
+	{
+		glm::mat4 model;
+		MESHLIST meshType;
+		int stateIndex;
+		bool blended;
+	};
+
 	// pointer to shader manager object
 	ShaderManager* m_pShaderManager;
 	// pointer to basic shapes object
@@ -113,6 +162,25 @@ private:
 	TEXTURE_INFO m_textureIDs[16];
 	// defined object materials
 	std::vector<OBJECT_MATERIAL> m_objectMaterials;
+	// distinct shader states of the draw list, indexed by QueuedDraw::stateIndex
+	std::vector<RenderState> m_renderStates;
+	// shader state after the last queued draw, carried into the second pass
+	RenderState m_currentState;
+	// objects making up the scene, in the order they were added
+	std::vector<RenderData> m_sceneObjects;
+	// true when an object changed since the draw list was built
+	bool m_sceneDirty;
+	// draws resolved from the scene objects in submission order
+	std::vector<QueuedDraw> m_drawQueue;
+	// queue indices in the order they are drawn
+	std::vector<int> m_drawOrder;
+	// the scene draws in the order they are drawn every frame
+	std::vector<QueuedDraw> m_sceneDraws;
+	// group id per mesh and state pair, and the size of each group
+	std::vector<int> m_groupOfKey;
+	std::vector<int> m_groupStart;
+	// counters for the last drawn frame
+	RenderStats m_frameStats;
 
 	// load texture images and convert to OpenGL texture data
 	bool CreateGLTexture(const char* filename, std::string tag);
@@ -125,6 +193,15 @@ private:
 	int FindTextureSlot(std::string tag);
 	// find a defined material by tag
 	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
+	int FindMaterialIndex(std::string tag);
+
+	// build the model matrix from the transformation values
+	static glm::mat4 ComputeModelMatrix(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
 
 	// set the transformation values 
 	// into the transform buffer
@@ -170,16 +247,39 @@ private:
 	void SetupSceneLights();
 
 	// Factory function for loading lists of Meshes to render
-	void RenderList(std::vector<RenderData> AssetList);
+	void AddObjectList(const std::vector<RenderData>& AssetList);
+	// resolve one object and queue it for drawing
+	void QueueObject(const RenderData& Asset);
+
+	// find or add a shader state, returning its index
+	int InternRenderState(const RenderState& state);
+	// upload a resolved shader state
+	void ApplyRenderState(const RenderState& state);
+	// issue the draw call for one mesh type
+	void DrawMesh(MESHLIST meshType);
+	// rebuild the draw list from the scene objects
+	void BuildDrawList();
+	// order the queued draws by mesh type and shader state
+	void SortDrawQueue();
+	// draw the built draw list
+	void DrawScene();
 public:
 
 	void PrepareScene();
 	void RenderScene();
-	void RenderWoodBase();
-	void RenderPlane();
-	void RenderCoffeeCup();
-	void RenderPitcher();
-	void RenderKettle();
-	void RenderCarafe();
+	void AddWoodBase();
+	void AddPlane();
+	void AddCoffeeCup();
+	void AddPitcher();
+	void AddKettle();
+	void AddCarafe();
 	void AxisReference();
+
+	// replace one scene object, the draw list is rebuilt before the next frame
+	bool UpdateSceneObject(size_t index, const RenderData& object);
+	// number of objects in the scene
+	size_t GetSceneObjectCount() const;
+
+	// counters for the last rendered frame
+	const RenderStats& GetRenderStats() const;
 };
@@ -0,0 +1,121 @@
+/*
+ * Program Name: Scan Kernel Benchmark
+ * Description: compares splitting CSV text into lines and fields through
+ * getline/stringstream (the original parser path) against each scan kernel
+ *
+ * Build: g++ -std=c++17 -O2 ScanKernelBench.cpp -o ScanKernelBench
+ * Usage: ScanKernelBench [megabytes]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "../ScanKernel.h"
+
+using namespace std;
+
+typedef const char *(*FindEitherFunction)(const char *, const char *, char, char);
+
+/**
+ * Builds CSV text shaped like classes.csv, one course per line
+ *
+ * @param bytes approximate size of the text
+ * @return generated text
+ */
+string GenerateCsv(size_t bytes)
+{
+    string text;
+    text.reserve(bytes + 128);
+    unsigned seed = 12345;
+    for (size_t row = 0; text.size() < bytes; row++)
+    {
+        seed = seed * 1103515245 + 12345;
+        text += "CSCI" + to_string(row) + ",Course Title Number " + to_string(row);
+        for (unsigned prereq = 0; prereq < (seed >> 16) % 4; prereq++)
+        {
+            text += ",CSCI" + to_string((seed >> 8) % (row + 1));
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+/**
+ * The original path: getline per line, then a stringstream and getline per field
+ */
+size_t SplitWithStreams(const string &text)
+{
+    size_t fields = 0;
+    stringstream source(text);
+    string line;
+    string token;
+    while (getline(source, line))
+    {
+        stringstream ss(line);
+        while (getline(ss, token, ','))
+        {
+            fields++;
+        }
+    }
+    return fields;
+}
+
+/**
+ * Kernel path: every ',' or '\n' ends a field, no copies are made
+ */
+size_t SplitWithKernel(const string &text, FindEitherFunction findEither)
+{
+    size_t fields = 0;
+    const char *position = text.data();
+    const char *end = position + text.size();
+    while (position < end)
+    {
+        const char *next = findEither(position, end, ',', '\n');
+        fields++;
+        position = next + 1;
+    }
+    return fields;
+}
+
+/**
+ * Times a splitter and prints its throughput
+ */
+template <typename Splitter>
+void Measure(const string &label, const string &text, Splitter split)
+{
+    auto start = chrono::steady_clock::now();
+    size_t fields = split();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    double megabytes = text.size() / (1024.0 * 1024.0);
+
+    cout << label << ": " << fields << " fields, " << seconds * 1000.0 << " ms, "
+         << megabytes / seconds << " MB/s" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t megabytes = argc > 1 ? strtoul(argv[1], nullptr, 10) : 64;
+    string text = GenerateCsv(megabytes * 1024 * 1024);
+    cout << "Input: " << text.size() << " bytes" << endl;
+
+    Measure("getline/stringstream", text, [&]()
+            { return SplitWithStreams(text); });
+    Measure("scalar kernel       ", text, [&]()
+            { return SplitWithKernel(text, ScanKernel::FindEitherScalar); });
+#ifdef SCAN_KERNEL_SSE2
+    Measure("sse2 kernel         ", text, [&]()
+            { return SplitWithKernel(text, ScanKernel::FindEitherSse2); });
+#endif
+#ifdef SCAN_KERNEL_AVX2
+    if (ScanKernel::HasAvx2())
+    {
+        Measure("avx2 kernel         ", text, [&]()
+                { return SplitWithKernel(text, ScanKernel::FindEitherAvx2); });
+    }
+#endif
+
+    return 0;
+}
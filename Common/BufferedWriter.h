@@ -0,0 +1,155 @@
+#pragma once
+
+/*
+ * Buffered Writer
+ * Description: output sink shared by the report and batch paths. Text is
+ * formatted into one reusable buffer and handed to the C runtime in large
+ * blocks, so writing a row costs no allocation and no flush.
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class BufferedWriter
+{
+public:
+    /**
+     * Writes to an already open stream such as stdout, the stream is not closed
+     *
+     * @param target stream receiving the output
+     * @param capacity bytes collected before a block is written
+     */
+    explicit BufferedWriter(FILE *target = stdout, size_t capacity = 1 << 16)
+        : target(target), buffer(capacity < 64 ? 64 : capacity)
+    {
+    }
+
+    ~BufferedWriter()
+    {
+        Close();
+    }
+
+    BufferedWriter(const BufferedWriter &) = delete;
+    BufferedWriter &operator=(const BufferedWriter &) = delete;
+
+    /**
+     * Redirects output to a new file owned by the writer
+     *
+     * @param path file to create or truncate
+     * @return status if the file could be opened
+     */
+    bool Open(const std::string &path)
+    {
+        FILE *file = nullptr;
+#ifdef _MSC_VER
+        fopen_s(&file, path.c_str(), "wb");
+#else
+        file = fopen(path.c_str(), "wb");
+#endif
+        if (file == nullptr)
+        {
+            return false;
+        }
+        Close();
+        target = file;
+        ownsTarget = true;
+        return true;
+    }
+
+    /**
+     * Flushes pending output and closes the target when the writer opened it
+     */
+    void Close()
+    {
+        Flush();
+        if (ownsTarget)
+        {
+            fclose(target);
+            target = stdout;
+            ownsTarget = false;
+        }
+    }
+
+    /**
+     * Hands every buffered byte to the target stream
+     */
+    void Flush()
+    {
+        if (used > 0)
+        {
+            fwrite(buffer.data(), 1, used, target);
+            used = 0;
+        }
+        fflush(target);
+    }
+
+    void Write(std::string_view text)
+    {
+        // text larger than the buffer skips it entirely
+        if (text.size() >= buffer.size())
+        {
+            Drain();
+            fwrite(text.data(), 1, text.size(), target);
+            return;
+        }
+        Reserve(text.size());
+        text.copy(buffer.data() + used, text.size());
+        used += text.size();
+    }
+
+    void Write(char c)
+    {
+        Reserve(1);
+        buffer[used++] = c;
+    }
+
+    void WriteNumber(uint64_t value)
+    {
+        Reserve(20);
+        std::to_chars_result result = std::to_chars(buffer.data() + used, buffer.data() + buffer.size(), value);
+        used = static_cast<size_t>(result.ptr - buffer.data());
+    }
+
+    /**
+     * Writes count copies of c without building a temporary string
+     */
+    void WriteRepeated(char c, size_t count)
+    {
+        while (count > 0)
+        {
+            Reserve(1);
+            size_t run = buffer.size() - used < count ? buffer.size() - used : count;
+            std::fill(buffer.data() + used, buffer.data() + used + run, c);
+            used += run;
+            count -= run;
+        }
+    }
+
+private:
+    /**
+     * Writes the buffer out when fewer than bytes are free
+     */
+    void Reserve(size_t bytes)
+    {
+        if (buffer.size() - used < bytes)
+        {
+            Drain();
+        }
+    }
+
+    void Drain()
+    {
+        fwrite(buffer.data(), 1, used, target);
+        used = 0;
+    }
+
+    FILE *target;
+    bool ownsTarget = false;
+    std::vector<char> buffer;
+    size_t used = 0;
+};
@@ -0,0 +1,257 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+	Swap(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other) {
+		Close();
+		Swap(other);
+	}
+	return *this;
+}
+
+void MappedFile::Swap(MappedFile& other) noexcept
+{
+	swap(data, other.data);
+	swap(size, other.size);
+	swap(open, other.open);
+	swap(identity, other.identity);
+	swap(modified, other.modified);
+#ifdef _WIN32
+	swap(fileHandle, other.fileHandle);
+	swap(mappingHandle, other.mappingHandle);
+#else
+	swap(fileDescriptor, other.fileDescriptor);
+#endif
+}
+
+#ifdef _WIN32
+
+namespace {
+	bool ReadFileInfo(HANDLE file, FileIdentity& identity, uint64_t& size, int64_t& modified)
+	{
+		BY_HANDLE_FILE_INFORMATION info;
+		if (!GetFileInformationByHandle(file, &info)) {
+			return false;
+		}
+		size = (static_cast<uint64_t>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+		identity.device = info.dwVolumeSerialNumber;
+		identity.file = (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+		modified = static_cast<int64_t>((static_cast<uint64_t>(info.ftLastWriteTime.dwHighDateTime) << 32)
+			| info.ftLastWriteTime.dwLowDateTime);
+		return true;
+	}
+}
+
+bool StatFile(const string& filePath, FileIdentity& identity, uint64_t& size, int64_t& modified)
+{
+	// no access rights are requested, the handle only reads attributes and never blocks writers
+	HANDLE file = CreateFileA(filePath.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		NULL, OPEN_EXISTING, 0, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	bool read = ReadFileInfo(file, identity, size, modified);
+	CloseHandle(file);
+	return read;
+}
+
+bool MappedFile::Open(const string& filePath)
+{
+	Close();
+
+	HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	fileHandle = file;
+
+	uint64_t fileSize = 0;
+	if (!ReadFileInfo(file, identity, fileSize, modified)) {
+		Close();
+		return false;
+	}
+	size = static_cast<size_t>(fileSize);
+	open = true;
+
+	// windows refuses to map an empty file
+	if (size == 0) {
+		return true;
+	}
+
+	mappingHandle = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mappingHandle == NULL) {
+		Close();
+		return false;
+	}
+
+	data = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (data == nullptr) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::Advise(FileAccess)
+{
+	// the sequential scan flag only steers cached ReadFile calls, mapped views page in on demand either way
+}
+
+void MappedFile::Close()
+{
+	if (data != nullptr) {
+		UnmapViewOfFile(data);
+	}
+	if (mappingHandle != nullptr) {
+		CloseHandle(mappingHandle);
+	}
+	if (fileHandle != nullptr) {
+		CloseHandle(fileHandle);
+	}
+	data = nullptr;
+	mappingHandle = nullptr;
+	fileHandle = nullptr;
+	size = 0;
+	open = false;
+	identity = FileIdentity();
+	modified = 0;
+}
+
+#else
+
+namespace {
+	void ReadFileInfo(const struct stat& info, FileIdentity& identity, uint64_t& size, int64_t& modified)
+	{
+		size = static_cast<uint64_t>(info.st_size);
+		identity.device = static_cast<uint64_t>(info.st_dev);
+		identity.file = static_cast<uint64_t>(info.st_ino);
+#ifdef __APPLE__
+		modified = static_cast<int64_t>(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+		modified = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+	}
+}
+
+bool StatFile(const string& filePath, FileIdentity& identity, uint64_t& size, int64_t& modified)
+{
+	struct stat info;
+	if (stat(filePath.c_str(), &info) != 0) {
+		return false;
+	}
+	ReadFileInfo(info, identity, size, modified);
+	return true;
+}
+
+bool MappedFile::Open(const string& filePath)
+{
+	Close();
+
+	fileDescriptor = ::open(filePath.c_str(), O_RDONLY);
+	if (fileDescriptor < 0) {
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(fileDescriptor, &info) != 0) {
+		Close();
+		return false;
+	}
+	uint64_t fileSize = 0;
+	ReadFileInfo(info, identity, fileSize, modified);
+	size = static_cast<size_t>(fileSize);
+	open = true;
+
+	if (size == 0) {
+		return true;
+	}
+
+	void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	if (mapping == MAP_FAILED) {
+		Close();
+		return false;
+	}
+	data = static_cast<const char*>(mapping);
+	// most files are read front to back, let the kernel read ahead aggressively
+	Advise(FileAccess::Sequential);
+	return true;
+}
+
+void MappedFile::Advise(FileAccess access)
+{
+	if (data != nullptr) {
+		madvise(const_cast<char*>(data), size, access == FileAccess::Sequential ? MADV_SEQUENTIAL : MADV_NORMAL);
+	}
+}
+
+void MappedFile::Close()
+{
+	if (data != nullptr) {
+		munmap(const_cast<char*>(data), size);
+	}
+	if (fileDescriptor >= 0) {
+		::close(fileDescriptor);
+	}
+	data = nullptr;
+	fileDescriptor = -1;
+	size = 0;
+	open = false;
+	identity = FileIdentity();
+	modified = 0;
+}
+
+#endif
+
+bool MappedFile::IsOpen() const
+{
+	return open;
+}
+
+const char* MappedFile::Data() const
+{
+	return data;
+}
+
+size_t MappedFile::Size() const
+{
+	return size;
+}
+
+string_view MappedFile::View() const
+{
+	return data == nullptr ? string_view() : string_view(data, size);
+}
+
+FileIdentity MappedFile::Identity() const
+{
+	return identity;
+}
+
+int64_t MappedFile::Modified() const
+{
+	return modified;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "ScanKernel.h"
+
+/*
+Description:
+	Identifies the file behind a path, a new identity means the path was
+	rotated to a different file (device and inode, or volume and file index).
+*/
+struct FileIdentity
+{
+	uint64_t device = 0;
+	uint64_t file = 0;
+
+	bool operator==(const FileIdentity& other) const
+	{
+		return device == other.device && file == other.file;
+	}
+	bool operator!=(const FileIdentity& other) const
+	{
+		return !(*this == other);
+	}
+};
+
+/*
+Description:
+	How a mapped file is going to be read, a hint for the operating system's paging.
+*/
+enum class FileAccess
+{
+	Sequential,	// front to back once, read ahead aggressively and drop pages behind
+	Mixed		// in any order and more than once, the default paging
+};
+
+/*
+Description:
+	Read only memory mapping of a whole file. The contents are paged in by the
+	operating system on demand, so scanning a multi-GB file costs no heap memory.
+Example:
+	MappedFile file;
+	if (file.Open("source.txt")) count(file.View());
+*/
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	// a mapping has a single owner
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	// map the file read only for FileAccess::Sequential reading, an empty file opens
+	// successfully with no data
+	bool Open(const std::string& filePath);
+
+	// change how the mapping is going to be read
+	void Advise(FileAccess access);
+
+	// unmap and close the file
+	void Close();
+
+	bool IsOpen() const;
+	const char* Data() const;
+	size_t Size() const;
+
+	// whole mapped file as text
+	std::string_view View() const;
+
+	// identity of the opened file
+	FileIdentity Identity() const;
+
+	// last write time of the opened file in platform ticks, only compared for equality
+	int64_t Modified() const;
+
+private:
+	void Swap(MappedFile& other) noexcept;
+
+	const char* data = nullptr;
+	size_t size = 0;
+	bool open = false;
+	FileIdentity identity;
+	int64_t modified = 0;
+#ifdef _WIN32
+	void* fileHandle = nullptr;		// HANDLE
+	void* mappingHandle = nullptr;	// HANDLE
+#else
+	int fileDescriptor = -1;
+#endif
+};
+
+/*
+Description:
+	Reads the identity, size and last write time of a file without mapping it,
+	cheap enough to poll a path for changes. Modified uses the same ticks as
+	MappedFile::Modified.
+*/
+bool StatFile(const std::string& filePath, FileIdentity& identity, uint64_t& size, int64_t& modified);
+
+/*
+Description:
+	Calls visit(line) for every line in text without copying. Lines are views
+	into text with the '\n' and any trailing '\r' removed, and a final line
+	with no terminating newline is still reported.
+*/
+template<typename Visitor>
+void ForEachLine(std::string_view text, Visitor&& visit)
+{
+	const char* base = text.data();
+	const char* last = base + text.size();
+	size_t begin = 0;
+	while (begin < text.size()) {
+		size_t end = static_cast<size_t>(ScanKernel::Find(base + begin, last, '\n') - base);
+		size_t next = end < text.size() ? end + 1 : end;
+
+		if (end > begin && text[end - 1] == '\r') {
+			end -= 1;
+		}
+		visit(text.substr(begin, end - begin));
+		begin = next;
+	}
+}
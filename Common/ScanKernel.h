@@ -0,0 +1,244 @@
+#pragma once
+
+/*
+ * Scan Kernel
+ * Description: byte search used by the text parsers (CS-210 Project4 line
+ * splitting, CS-300 CoursePlanner CSV loading). Finds '\n' and ',' 32 bytes
+ * at a time with AVX2, 16 at a time with SSE2, or one at a time when neither
+ * is available. AVX2 is picked at run time so one binary runs everywhere.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCAN_KERNEL_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SCAN_KERNEL_AVX2 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SCAN_KERNEL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SCAN_KERNEL_TARGET_AVX2
+#endif
+
+namespace ScanKernel
+{
+
+/**
+ * Index of the lowest set bit of a non zero mask
+ */
+inline unsigned LowestBit(uint32_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+/**
+ * Number of set bits in a mask
+ */
+inline unsigned BitCount(uint32_t mask)
+{
+#ifdef _MSC_VER
+    unsigned count = 0;
+    for (; mask != 0; mask &= mask - 1)
+    {
+        count++;
+    }
+    return count;
+#else
+    return static_cast<unsigned>(__builtin_popcount(mask));
+#endif
+}
+
+/******************* Scalar *******************/
+
+/**
+ * First position of a or b in [begin, end), end if neither occurs
+ */
+inline const char *FindEitherScalar(const char *begin, const char *end, char a, char b)
+{
+    for (; begin < end; ++begin)
+    {
+        if (*begin == a || *begin == b)
+        {
+            return begin;
+        }
+    }
+    return end;
+}
+
+/**
+ * Occurrences of c in [begin, end)
+ */
+inline size_t CountScalar(const char *begin, const char *end, char c)
+{
+    size_t count = 0;
+    for (; begin < end; ++begin)
+    {
+        count += *begin == c;
+    }
+    return count;
+}
+
+/******************* SSE2 *******************/
+
+#ifdef SCAN_KERNEL_SSE2
+inline const char *FindEitherSse2(const char *begin, const char *end, char a, char b)
+{
+    const __m128i matchA = _mm_set1_epi8(a);
+    const __m128i matchB = _mm_set1_epi8(b);
+    for (; end - begin >= 16; begin += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(block, matchA), _mm_cmpeq_epi8(block, matchB));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hits));
+        if (mask != 0)
+        {
+            return begin + LowestBit(mask);
+        }
+    }
+    return FindEitherScalar(begin, end, a, b);
+}
+
+inline size_t CountSse2(const char *begin, const char *end, char c)
+{
+    const __m128i match = _mm_set1_epi8(c);
+    size_t count = 0;
+    for (; end - begin >= 16; begin += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+        count += BitCount(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, match))));
+    }
+    return count + CountScalar(begin, end, c);
+}
+#endif
+
+/******************* AVX2 *******************/
+
+#ifdef SCAN_KERNEL_AVX2
+SCAN_KERNEL_TARGET_AVX2
+inline const char *FindEitherAvx2(const char *begin, const char *end, char a, char b)
+{
+    const __m256i matchA = _mm256_set1_epi8(a);
+    const __m256i matchB = _mm256_set1_epi8(b);
+    for (; end - begin >= 32; begin += 32)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(block, matchA), _mm256_cmpeq_epi8(block, matchB));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+        if (mask != 0)
+        {
+            return begin + LowestBit(mask);
+        }
+    }
+    return FindEitherSse2(begin, end, a, b);
+}
+
+SCAN_KERNEL_TARGET_AVX2
+inline size_t CountAvx2(const char *begin, const char *end, char c)
+{
+    const __m256i match = _mm256_set1_epi8(c);
+    size_t count = 0;
+    for (; end - begin >= 32; begin += 32)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+        count += BitCount(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, match))));
+    }
+    return count + CountSse2(begin, end, c);
+}
+
+/**
+ * Checks cpuid and the OS saved register state for AVX2 support
+ */
+inline bool DetectAvx2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+inline bool HasAvx2()
+{
+    static const bool supported = DetectAvx2();
+    return supported;
+}
+#endif
+
+/******************* Dispatch *******************/
+
+/**
+ * First position of a or b in [begin, end) using the widest supported kernel
+ *
+ * @param begin start of the text
+ * @param end one past the end of the text
+ * @param a first byte to look for
+ * @param b second byte to look for
+ * @return pointer to the match or end when there is none
+ */
+inline const char *FindEither(const char *begin, const char *end, char a, char b)
+{
+#if defined(SCAN_KERNEL_AVX2)
+    if (HasAvx2())
+    {
+        return FindEitherAvx2(begin, end, a, b);
+    }
+#endif
+#if defined(SCAN_KERNEL_SSE2)
+    return FindEitherSse2(begin, end, a, b);
+#else
+    return FindEitherScalar(begin, end, a, b);
+#endif
+}
+
+/**
+ * First position of c in [begin, end), end if it does not occur
+ */
+inline const char *Find(const char *begin, const char *end, char c)
+{
+    return FindEither(begin, end, c, c);
+}
+
+/**
+ * Occurrences of c in [begin, end) using the widest supported kernel
+ */
+inline size_t Count(const char *begin, const char *end, char c)
+{
+#if defined(SCAN_KERNEL_AVX2)
+    if (HasAvx2())
+    {
+        return CountAvx2(begin, end, c);
+    }
+#endif
+#if defined(SCAN_KERNEL_SSE2)
+    return CountSse2(begin, end, c);
+#else
+    return CountScalar(begin, end, c);
+#endif
+}
+
+} // namespace ScanKernel